@@ -12,6 +12,7 @@
 #define ZEPHYR_INCLUDE_INPUT_PAW32XX_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
@@ -20,6 +21,54 @@
 
 /* These functions are declared in paw3222_power.h */
 
+/** @brief Number of shadowed registers, PAW32XX_OPERATION_MODE (0x05) through PAW32XX_CPI_Y (0x0e) */
+#define PAW32XX_SHADOW_LEN 10
+
+/** @brief Number of bytes in the packed layer-to-mode table (two layers per byte) */
+#define PAW32XX_LAYER_MODES_LEN 16
+/** @brief Number of layers covered by the layer-to-mode table (ZMK layer state is 32 bits) */
+#define PAW32XX_MAX_LAYERS (PAW32XX_LAYER_MODES_LEN * 2)
+
+/**
+ * @brief Relative axes reported by the driver
+ *
+ * Indexes paw32xx_data::report_pending; events of one report are sent in
+ * this order and the last non-zero axis carries the sync flag.
+ */
+enum paw32xx_report_axis {
+  PAW32XX_AXIS_X,       /**< INPUT_REL_X */
+  PAW32XX_AXIS_Y,       /**< INPUT_REL_Y */
+  PAW32XX_AXIS_WHEEL,   /**< INPUT_REL_WHEEL */
+  PAW32XX_AXIS_HWHEEL,  /**< INPUT_REL_HWHEEL */
+  PAW32XX_AXIS_COUNT,   /**< Number of reported axes */
+};
+
+/** @brief Number of entries in the pointer acceleration table (speed 0-127 counts/ms) */
+#define PAW32XX_ACCEL_LUT_LEN 128
+/** @brief Acceleration gain of 1.0 in the Q8 fixed-point table format */
+#define PAW32XX_ACCEL_GAIN_ONE 256
+
+/**
+ * @brief Pointer acceleration curve types
+ */
+enum paw32xx_accel_curve_type {
+  PAW32XX_ACCEL_NONE,    /**< No acceleration */
+  PAW32XX_ACCEL_LINEAR,  /**< Gain rises linearly with speed */
+  PAW32XX_ACCEL_POWER,   /**< Gain rises with speed raised to an integer exponent */
+  PAW32XX_ACCEL_SIGMOID, /**< Gain follows a smoothstep S-curve */
+};
+
+/**
+ * @brief Pointer acceleration curve parameters (from device tree)
+ */
+struct paw32xx_accel_curve {
+  enum paw32xx_accel_curve_type type;          /**< Curve shape */
+  uint16_t gain_max;                           /**< Gain at speed_max, in percent */
+  uint8_t speed_min;                           /**< Speed (counts/ms) where acceleration starts */
+  uint8_t speed_max;                           /**< Speed (counts/ms) where gain_max is reached */
+  uint8_t exponent;                            /**< Exponent of the power curve */
+};
+
 /**
  * @brief Input mode switching methods
  * 
@@ -45,6 +94,29 @@ enum paw32xx_current_mode {
   PAW32XX_MODE_SCROLL_HORIZONTAL_SNIPE, /**< High-precision horizontal scrolling mode */
 };
 
+/**
+ * @brief Sleep power profiles
+ *
+ * A profile selects the SLEEP1..SLEEP3 timing and which sleep modes the
+ * sensor may enter while force-awake is off, trading wake-from-sleep
+ * latency against idle current.
+ */
+enum paw32xx_power_profile {
+  PAW32XX_POWER_LATENCY,                       /**< Sleep 1 only, entered late at the fastest frame rate */
+  PAW32XX_POWER_BALANCED,                      /**< Sensor reset timing, sleep 1 and 2 */
+  PAW32XX_POWER_BATTERY,                       /**< Sleep 1 and 2, entered early at the slowest frame rates */
+  PAW32XX_POWER_PROFILE_COUNT,                 /**< Number of power profiles */
+};
+
+/**
+ * @brief Sensor bring-up state, see paw32xx_is_ready()
+ */
+enum paw32xx_init_state {
+  PAW32XX_INIT_PENDING,                        /**< Sensor not configured yet */
+  PAW32XX_INIT_DONE,                           /**< Sensor configured, motion interrupt armed */
+  PAW32XX_INIT_FAILED,                         /**< Bring-up failed, the sensor is unusable */
+};
+
 /**
  * @brief PAW3222 device configuration structure
  *
@@ -60,16 +132,7 @@ struct paw32xx_config {
   struct gpio_dt_spec power_gpio;              /**< Power control GPIO specification (optional) */
   
   /* Layer-based mode switching configuration */
-  size_t scroll_layers_len;                    /**< Number of scroll layers defined */
-  int32_t *scroll_layers;                      /**< Array of layer IDs for vertical scroll mode */
-  size_t snipe_layers_len;                     /**< Number of snipe layers defined */
-  int32_t *snipe_layers;                       /**< Array of layer IDs for snipe mode */
-  size_t scroll_horizontal_layers_len;         /**< Number of horizontal scroll layers defined */
-  int32_t *scroll_horizontal_layers;           /**< Array of layer IDs for horizontal scroll mode */
-  size_t scroll_snipe_layers_len;              /**< Number of scroll snipe layers defined */
-  int32_t *scroll_snipe_layers;                /**< Array of layer IDs for high-precision vertical scroll */
-  size_t scroll_horizontal_snipe_layers_len;   /**< Number of horizontal scroll snipe layers defined */
-  int32_t *scroll_horizontal_snipe_layers;     /**< Array of layer IDs for high-precision horizontal scroll */
+  uint8_t layer_modes[PAW32XX_LAYER_MODES_LEN]; /**< Input mode per layer, packed two 4-bit entries per byte */
   
   /* Sensor configuration */
   int16_t res_cpi;                             /**< Default CPI resolution (608-4826) */
@@ -78,13 +141,158 @@ struct paw32xx_config {
   uint8_t scroll_snipe_divisor;                /**< Additional precision divisor for scroll snipe mode */
   uint8_t scroll_snipe_tick;                   /**< Scroll tick threshold for snipe mode */
   bool force_awake;                            /**< Force sensor to stay awake (disable sleep modes) */
+  enum paw32xx_power_profile power_profile;    /**< Sleep power profile applied at init */
   uint16_t rotation;                           /**< Physical sensor rotation angle (0, 90, 180, 270 degrees) */
   uint8_t scroll_tick;                         /**< Scroll tick threshold for normal scroll modes */
+  uint32_t poll_min_us;                        /**< Shortest motion poll interval in microseconds */
+  uint32_t poll_max_us;                        /**< Longest motion poll interval in microseconds */
+  uint32_t coalesce_us;                        /**< Report coalescing window in microseconds, 0 to disable */
+  uint32_t autosuspend_ms;                     /**< Runtime PM auto-suspend delay after the last motion */
+  uint32_t awake_idle_ms;                      /**< Idle time before dynamic force-awake re-enables sleep */
+  uint32_t awake_layers;                       /**< Bitmask of layers that keep the sensor awake */
+  uint16_t power_off_ms;                       /**< Minimum time the gated supply is held off at boot */
+  uint16_t power_on_ms;                        /**< Minimum time after enabling the supply before polling */
+  uint16_t ready_timeout_ms;                   /**< Bound on polling the product ID after power-up */
+  struct paw32xx_accel_curve accel;            /**< Pointer acceleration curve for move mode */
 
   /* Mode switching configuration */
   enum paw32xx_mode_switch_method switch_method; /**< Method used for input mode switching */
 };
 
+/**
+ * @brief Runtime-tunable motion parameters
+ *
+ * Copied from struct paw32xx_config when the device is initialized. The
+ * motion path reads these instead of the devicetree values so they can be
+ * retuned at runtime (e.g. from the paw3222 shell commands).
+ */
+struct paw32xx_params {
+  int16_t res_cpi;                             /**< CPI resolution for normal modes */
+  int16_t snipe_cpi;                           /**< CPI resolution for snipe mode */
+  uint8_t snipe_divisor;                       /**< Precision divisor for snipe mode */
+  uint8_t scroll_snipe_divisor;                /**< Precision divisor for scroll snipe modes */
+  uint8_t scroll_tick;                         /**< Scroll tick threshold for normal scroll modes */
+  uint8_t scroll_snipe_tick;                   /**< Scroll tick threshold for scroll snipe modes */
+  uint16_t rotation;                           /**< Sensor rotation used for scroll (0, 90, 180, 270) */
+  uint32_t coalesce_us;                        /**< Report coalescing window in microseconds */
+};
+
+/**
+ * @brief Per-device motion counters
+ */
+struct paw32xx_stats {
+  uint32_t samples;                            /**< Motion samples read from the sensor */
+  uint32_t reports;                            /**< Input reports sent (counted per sync event) */
+  uint32_t spi_errors;                         /**< Failed SPI transactions */
+  uint32_t mode_switches;                      /**< Input mode changes */
+  uint32_t report_merges;                      /**< Reports held back by a full input queue and merged */
+  uint32_t awake_toggles;                      /**< Dynamic force-awake transitions */
+};
+
+/**
+ * @brief Motion work queue-wait statistics
+ *
+ * Time between submitting the motion work item (from the motion interrupt
+ * or the poll timer) and the work handler starting to run.
+ */
+struct paw32xx_queue_wait_stats {
+  uint32_t count;                              /**< Number of measured work items */
+  uint32_t last_us;                            /**< Queue wait of the most recent work item */
+  uint32_t max_us;                             /**< Longest queue wait observed */
+  uint64_t total_us;                           /**< Sum of all queue waits, for averaging */
+};
+
+/** Number of buckets in each motion latency histogram */
+#define PAW32XX_LATENCY_BUCKETS 16
+
+/**
+ * @brief Motion latency stages measured by CONFIG_PAW3222_LATENCY_STATS
+ */
+enum paw32xx_latency_stage {
+  PAW32XX_LATENCY_QUEUE,                       /**< Work submitted (IRQ or poll timer) to work start */
+  PAW32XX_LATENCY_SPI,                         /**< Work start to motion burst read complete */
+  PAW32XX_LATENCY_MODE,                        /**< Burst read complete to input mode resolved */
+  PAW32XX_LATENCY_REPORT,                      /**< Input mode resolved to input reports done, including any coalescing wait */
+  PAW32XX_LATENCY_TOTAL,                       /**< Work submitted to input reports done */
+  PAW32XX_LATENCY_STAGES,                      /**< Number of latency stages */
+};
+
+/**
+ * @brief Latency histogram of one motion processing stage
+ *
+ * Bucket 0 counts durations below 1 us, bucket i counts durations in
+ * [2^(i-1), 2^i) us. The last bucket also collects everything longer.
+ */
+struct paw32xx_latency_hist {
+  uint32_t buckets[PAW32XX_LATENCY_BUCKETS];   /**< Sample count per log2 duration bucket */
+  uint32_t count;                              /**< Number of recorded samples */
+  uint32_t max_us;                             /**< Longest duration observed */
+  uint64_t total_us;                           /**< Sum of all durations, for averaging */
+};
+
+/**
+ * @brief Motion latency histograms of all stages
+ */
+struct paw32xx_latency_stats {
+  struct paw32xx_latency_hist stage[PAW32XX_LATENCY_STAGES]; /**< Histograms indexed by enum paw32xx_latency_stage */
+};
+
+/**
+ * @brief Motion delta saturation statistics
+ */
+struct paw32xx_saturation_stats {
+  uint32_t samples;                            /**< Samples with a delta clipped at the 8-bit limit */
+  uint32_t cpi_reductions;                     /**< Times the hardware CPI was halved to avoid clipping */
+};
+
+/**
+ * @brief Runtime PM statistics of CONFIG_PAW3222_PM_AUTOSUSPEND
+ *
+ * A wake is measured from the motion path requesting a runtime resume to
+ * the first input report sent afterwards.
+ */
+struct paw32xx_pm_stats {
+  uint32_t resumes;                            /**< Runtime resumes requested by the motion path */
+  uint32_t suspends;                           /**< Auto-suspends after the sensor went idle */
+  uint32_t wake_count;                         /**< Number of measured wakes */
+  uint32_t wake_last_us;                       /**< Resume-to-first-report latency of the last wake */
+  uint32_t wake_max_us;                        /**< Longest resume-to-first-report latency */
+  uint64_t wake_total_us;                      /**< Sum of all wake latencies, for averaging */
+};
+
+/**
+ * @brief One motion sample of the CONFIG_PAW3222_TRACE recorder
+ *
+ * Deltas are the sensor counts rescaled to the target CPI of the mode, i.e.
+ * exactly what paw32xx_process_sample() is given, so a trace replays
+ * bit-exactly. A sample without MOTION_STATUS_MOTION marks the end of a
+ * stroke.
+ */
+struct paw32xx_trace_entry {
+  uint32_t time_us;                            /**< Sample time in microseconds, wraps */
+  int16_t x;                                   /**< X delta */
+  int16_t y;                                   /**< Y delta */
+  uint8_t status;                              /**< MOTION register value */
+  uint8_t mode;                                /**< enum paw32xx_input_mode of the sample */
+};
+
+/** @brief Format of a dumped trace entry, a C initializer for the replay harness */
+#define PAW32XX_TRACE_FMT "{ %u, %d, %d, 0x%02x, %u },"
+/** @brief Arguments matching PAW32XX_TRACE_FMT */
+#define PAW32XX_TRACE_ARGS(entry)                                                          \
+  (entry)->time_us, (entry)->x, (entry)->y, (entry)->status, (entry)->mode
+
+/**
+ * @brief Boot timing, recorded once per boot
+ *
+ * All values are milliseconds of system uptime, 0 until the event happened.
+ */
+struct paw32xx_boot_stats {
+  uint32_t ready_ms;                           /**< Time spent polling the product ID at init */
+  uint32_t init_done_ms;                       /**< Uptime when device init completed */
+  uint32_t first_report_ms;                    /**< Uptime when the first input report was sent */
+};
+
 /**
  * @brief PAW3222 runtime data structure
  *
@@ -98,14 +306,110 @@ struct paw32xx_config {
 struct paw32xx_data {
   const struct device *dev;                   /**< Pointer to the device instance */
   struct k_work motion_work;                  /**< Work queue item for motion processing */
+  struct k_work cpi_work;                     /**< Work queue item applying target_cpi to the sensor */
   struct gpio_callback motion_cb;             /**< GPIO callback for motion interrupt */
   struct k_timer motion_timer;                /**< Timer for motion processing timeout */
   int16_t current_cpi;                        /**< Currently configured CPI value */
+  struct paw32xx_params params;               /**< Runtime-tunable copy of the motion parameters */
+  struct paw32xx_params pending_params;       /**< Latest params requested by paw32xx_set_params() */
+  struct k_work params_work;                  /**< Work queue item copying pending_params to params */
+  struct paw32xx_stats stats;                 /**< Motion counters */
+  struct paw32xx_boot_stats boot;             /**< Boot timing */
+  atomic_t init_state;                        /**< enum paw32xx_init_state, see paw32xx_is_ready() */
+#ifdef CONFIG_PM_DEVICE
+  atomic_t powered_off;                       /**< Supply cut by PM suspend, see paw32xx_is_powered() */
+#endif
+#ifdef CONFIG_PAW3222_ASYNC_INIT
+  struct k_work_delayable init_work;          /**< Deferred sensor bring-up */
+#endif
+  int16_t report_pending[PAW32XX_AXIS_COUNT]; /**< Deltas not yet accepted by the input subsystem */
+  struct k_work_delayable report_work;        /**< Sends the coalesced report at the end of a window */
+  bool report_window_open;                    /**< A coalescing window is running */
+  struct k_mutex bus_lock;                    /**< Serializes SPI transactions, see paw32xx_bus_lock() */
+  uint8_t reg_shadow[PAW32XX_SHADOW_LEN];     /**< Last known values of the writable configuration registers */
+  uint16_t reg_shadow_valid;                  /**< Bitmask of reg_shadow entries that match the sensor */
+  uint8_t sleep_defaults[3];                  /**< SLEEP1..SLEEP3 reset values, used by the balanced profile */
+  bool sleep_defaults_valid;                  /**< sleep_defaults has been read from the sensor */
+  uint8_t power_profile;                      /**< Active enum paw32xx_power_profile */
+  bool force_awake_active;                    /**< Sleep modes are currently disabled */
   int16_t scroll_accumulator;                 /**< Accumulator for smooth scrolling (reduced from int32_t) */
+  uint32_t poll_interval_us;                  /**< Last chosen motion poll interval, 0 while idle */
+
+  /* Sub-count remainders carried across samples by the precision divisors */
+  int16_t snipe_remainder_x;                  /**< X remainder of the snipe divisor */
+  int16_t snipe_remainder_y;                  /**< Y remainder of the snipe divisor */
+  int16_t scroll_snipe_remainder;             /**< Scroll remainder of the scroll snipe divisor */
+  int16_t cpi_remainder_x;                    /**< X remainder of the CPI transition rescale */
+  int16_t cpi_remainder_y;                    /**< Y remainder of the CPI transition rescale */
+
+#ifdef CONFIG_PAW3222_ACCEL
+  /* Pointer acceleration */
+  uint16_t accel_lut[PAW32XX_ACCEL_LUT_LEN];  /**< Q8 gain per speed in counts/ms, built at init */
+  int16_t accel_remainder_x;                  /**< X fraction (Q8) carried to the next sample */
+  int16_t accel_remainder_y;                  /**< Y fraction (Q8) carried to the next sample */
+  uint32_t accel_last_us;                     /**< Timestamp of the previous move sample */
+#endif
+
+  /* Delta saturation compensation */
+  uint8_t cpi_reduction;                      /**< Number of times target_cpi is halved in hardware */
+  struct paw32xx_saturation_stats saturation; /**< Saturation statistics */
+
+#ifdef CONFIG_PAW3222_QUEUE_WAIT_STATS
+  uint32_t motion_submit_cycles;              /**< Cycle count when motion work was last queued */
+  bool motion_submit_pending;                 /**< motion_submit_cycles belongs to queued work */
+  struct paw32xx_queue_wait_stats queue_wait; /**< Queue-wait statistics for motion work */
+#endif
+
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+  uint32_t latency_submit_cycles;             /**< Cycle count when motion work was last queued */
+  bool latency_submit_pending;                /**< latency_submit_cycles belongs to queued work */
+  bool latency_valid;                         /**< Sample being processed has a submit timestamp */
+  uint32_t latency_marks[PAW32XX_LATENCY_STAGES]; /**< Stage timestamps of the sample being processed */
+  uint32_t latency_report_marks[PAW32XX_LATENCY_STAGES]; /**< Stage timestamps of the latest sample awaiting a report */
+  bool latency_report_pending;                /**< latency_report_marks are timed by the next report */
+  struct paw32xx_latency_stats latency;       /**< Motion latency histograms */
+#endif
+
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+  /* Runtime PM */
+  struct k_work_delayable pm_suspend_work;    /**< Releases the runtime PM reference once motion is idle */
+  bool pm_active;                             /**< The motion path holds a runtime PM reference */
+  bool pm_wake_pending;                       /**< pm_resume_cycles awaits the first report */
+  uint32_t pm_resume_cycles;                  /**< Cycle count when the last runtime resume was requested */
+  struct paw32xx_pm_stats pm;                 /**< Runtime PM statistics */
+#endif
+
+#ifdef CONFIG_PAW3222_TRACE
+  /* Motion trace recorder */
+  struct paw32xx_trace_entry trace[CONFIG_PAW3222_TRACE_ENTRIES]; /**< Ring of recorded samples */
+  uint32_t trace_count;                       /**< Samples recorded since the last clear */
+  bool trace_enabled;                         /**< New samples are recorded */
+#endif
+
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+  /* Dynamic force-awake */
+  struct k_work_delayable awake_work;         /**< Applies the force-awake state the activity calls for */
+  bool awake_hold;                            /**< Input mode or layer keeps the sensor awake */
+#endif
 
   /* Mode switching state */
+  struct k_spinlock mode_lock;                /**< Guards input_mode, target_cpi, awake_hold and params updates */
   enum paw32xx_current_mode current_mode;     /**< Current operational mode of the sensor */
   bool mode_toggle_state;                     /**< Toggle state for behavior-based mode switching */
+  uint8_t input_mode;                         /**< Cached enum paw32xx_input_mode used by the motion path */
+  int16_t target_cpi;                         /**< CPI required by the cached input mode */
 };
 
+/**
+ * @brief Get a PAW3222 device instance by index
+ *
+ * Enumerates the enabled PAW3222 devicetree instances, e.g. for shell
+ * commands that need to list or look up sensors.
+ *
+ * @param index Instance index, starting at 0
+ *
+ * @return Device pointer, or NULL if index is past the last instance
+ */
+const struct device *paw32xx_get_device(size_t index);
+
 #endif /* ZEPHYR_INCLUDE_INPUT_PAW32XX_H_ */
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2025 nuovotaka
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef PAW3222_EMUL_H_
+#define PAW3222_EMUL_H_
+
+#include <stdint.h>
+#include <zephyr/drivers/emul.h>
+
+/**
+ * @brief SPI traffic counters collected by the PAW3222 emulator
+ *
+ * Every field counts events since the emulator was created or since the
+ * last call to paw32xx_emul_reset_stats(). The counters are intended for
+ * tests that assert on bus cost (e.g. transactions per motion sample).
+ */
+struct paw32xx_emul_stats {
+  uint32_t transfers;     /**< Number of SPI transactions (CS assertions) */
+  uint32_t reg_reads;     /**< Number of register read cycles */
+  uint32_t reg_writes;    /**< Number of register write cycles accepted */
+  uint32_t wp_violations; /**< Writes dropped because write protection was enabled */
+  uint32_t resets;        /**< Software resets through CONFIGURATION */
+};
+
+/**
+ * @brief Queue a scripted motion sample on the emulated sensor
+ *
+ * Appends a motion sample to the emulator's FIFO. The head of the FIFO is
+ * latched into DELTA_X/DELTA_Y when the MOTION register is read and popped
+ * once DELTA_Y has been read, mirroring the read sequence used by the driver.
+ * The motion pin is asserted while the FIFO is not empty.
+ *
+ * @param target PAW3222 emulator instance (must not be NULL)
+ * @param dx X delta reported by the sample
+ * @param dy Y delta reported by the sample
+ *
+ * @return 0 on success, negative error code on failure
+ * @retval 0 Sample queued successfully
+ * @retval -ENOMEM Motion FIFO is full (see CONFIG_PAW3222_EMUL_FIFO_SIZE)
+ */
+int paw32xx_emul_push_motion(const struct emul *target, int8_t dx, int8_t dy);
+
+/**
+ * @brief Drop all scripted motion samples still queued on the emulator
+ *
+ * @param target PAW3222 emulator instance (must not be NULL)
+ */
+void paw32xx_emul_flush_motion(const struct emul *target);
+
+/**
+ * @brief Get the number of motion samples still queued on the emulator
+ *
+ * @param target PAW3222 emulator instance (must not be NULL)
+ *
+ * @return Number of samples not yet consumed by the driver
+ */
+uint32_t paw32xx_emul_pending_motion(const struct emul *target);
+
+/**
+ * @brief Read an emulated register without going through the SPI bus
+ *
+ * @param target PAW3222 emulator instance (must not be NULL)
+ * @param addr Register address (0x00-0x7F)
+ *
+ * @return Current register value
+ */
+uint8_t paw32xx_emul_get_reg(const struct emul *target, uint8_t addr);
+
+/**
+ * @brief Write an emulated register without going through the SPI bus
+ *
+ * Bypasses write protection. Useful for forcing a register state in tests.
+ *
+ * @param target PAW3222 emulator instance (must not be NULL)
+ * @param addr Register address (0x00-0x7F)
+ * @param value New register value
+ */
+void paw32xx_emul_set_reg(const struct emul *target, uint8_t addr, uint8_t value);
+
+/**
+ * @brief Get the SPI traffic counters of the emulator
+ *
+ * @param target PAW3222 emulator instance (must not be NULL)
+ * @param stats Pointer to store the counters (must not be NULL)
+ */
+void paw32xx_emul_get_stats(const struct emul *target, struct paw32xx_emul_stats *stats);
+
+/**
+ * @brief Reset the SPI traffic counters of the emulator
+ *
+ * @param target PAW3222 emulator instance (must not be NULL)
+ */
+void paw32xx_emul_reset_stats(const struct emul *target);
+
+#endif /* PAW3222_EMUL_H_ */
@@ -13,6 +13,7 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/kernel.h>
 
+#include "paw3222.h"
 #include "paw3222_regs.h"
 
 /**
@@ -34,28 +35,271 @@
  * 
  * @note This function is called during motion processing to determine how
  *       to interpret sensor data. The behavior depends on the switch_method
- *       configured in the device tree.
+ *       configured in the device tree. Layer-based lookups resolve through a
+ *       table generated from the *-layers properties at build time, so the
+ *       cost does not depend on the number of configured layers.
  */
 enum paw32xx_input_mode
 get_input_mode_for_current_layer(const struct device *dev);
 
-#ifdef CONFIG_PAW3222_BEHAVIOR
 /**
- * @brief Set the PAW3222 device reference for behavior-based mode switching
+ * @brief Recompute the cached input mode and target CPI
  *
- * Stores a global reference to the PAW3222 device instance for use by the
- * behavior driver. This allows the behavior system to control the sensor's
- * input mode without direct device access.
+ * Resolves the input mode with get_input_mode_for_current_layer() and
+ * stores it, together with the CPI that mode requires, in the driver data.
+ * The motion work handler only reads these cached values, so this must be
+ * called whenever the inputs of the mode decision change: on ZMK layer state
+ * changes (done by the driver's layer_state_changed listener) and when the
+ * behavior changes the toggle mode.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ *
+ * @note The new mode applies to the next motion sample processed. A CPI
+ *       change is queued on the motion workqueue (see
+ *       paw32xx_cpi_work_handler()) instead of being applied here.
+ */
+void paw32xx_update_input_mode(const struct device *dev);
+
+/**
+ * @brief Get the runtime motion parameters
+ *
+ * Returns the parameters most recently passed to paw32xx_set_params(),
+ * which may not have reached the motion path yet.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param params Filled with the parameters (must not be NULL)
+ */
+void paw32xx_get_params(const struct device *dev, struct paw32xx_params *params);
+
+/**
+ * @brief Replace the runtime motion parameters
+ *
+ * The motion work handler reads data->params without locking, so the new
+ * parameters are staged and copied in by paw32xx_params_work_handler() on
+ * the motion workqueue, between two samples. The input mode is then
+ * re-resolved to pick up CPI changes.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param params New parameters (must not be NULL)
+ *
+ * @note Safe to call from any thread. Parameters set again before the work
+ *       runs replace the staged ones.
+ */
+void paw32xx_set_params(const struct device *dev, const struct paw32xx_params *params);
+
+/**
+ * @brief Get the motion poll interval currently in use
+ *
+ * While the sensor reports motion, the driver re-arms its poll timer with an
+ * interval chosen from the magnitude of the latest deltas, between the
+ * poll-min-us and poll-max-us bounds. This returns the interval chosen for
+ * the most recent sample.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ *
+ * @return Poll interval in microseconds, or 0 when polling is idle and the
+ *         driver is waiting for the motion interrupt
+ */
+uint32_t paw32xx_get_poll_interval_us(const struct device *dev);
+
+/**
+ * @brief Report work handler - ends a report coalescing window
+ *
+ * Sends the deltas summed during the window. If anything was sent (or is
+ * still held back by a full input queue), a new window is started so that
+ * at most one report goes out per window; otherwise the window closes and
+ * the next motion sample is reported immediately.
+ *
+ * @param work Pointer to the work item being processed (must not be NULL)
+ */
+void paw32xx_report_work_handler(struct k_work *work);
+
+#ifdef CONFIG_PAW3222_ACCEL
+/**
+ * @brief Build a pointer acceleration gain table
+ *
+ * Evaluates the curve once per speed step (0 to PAW32XX_ACCEL_LUT_LEN - 1
+ * counts per millisecond) using integer math only. Each entry is a Q8 gain
+ * (PAW32XX_ACCEL_GAIN_ONE = 1.0) applied to move-mode deltas by the
+ * motion work handler with a single lookup and multiply.
+ *
+ * @param curve Curve parameters (must not be NULL)
+ * @param lut Table of PAW32XX_ACCEL_LUT_LEN entries to fill (must not be NULL)
+ *
+ * @note The sigmoid curve is a smoothstep (3u^2 - 2u^3) between
+ *       speed_min and speed_max, which needs no exponential.
+ */
+void paw32xx_accel_build_lut(const struct paw32xx_accel_curve *curve, uint16_t *lut);
+#endif
+
+/**
+ * @brief Schedule driver work on the motion workqueue
+ *
+ * Uses the dedicated motion workqueue when CONFIG_PAW3222_MOTION_WORKQUEUE
+ * is enabled, otherwise the system workqueue, so deferred work shares the
+ * queue that serializes the driver's SPI transactions.
+ *
+ * @param dwork Delayable work item to schedule
+ * @param delay Delay before the work runs
+ *
+ * @return Result of k_work_schedule_for_queue()
+ */
+int paw32xx_schedule_work(struct k_work_delayable *dwork, k_timeout_t delay);
+
+/**
+ * @brief Get the motion counters of a device
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param stats Pointer to store the counters (must not be NULL)
+ *
+ * @return 0 on success
+ */
+int paw32xx_get_stats(const struct device *dev, struct paw32xx_stats *stats);
+
+/**
+ * @brief Get the boot timing of a device
+ *
+ * Copies how long init waited for the sensor to answer, when init completed
+ * and when the first input report was sent after boot.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param stats Pointer to store the timing (must not be NULL)
+ *
+ * @return 0 on success
+ */
+int paw32xx_get_boot_stats(const struct device *dev, struct paw32xx_boot_stats *stats);
+
+/**
+ * @brief Reset the motion counters of a device
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ */
+void paw32xx_reset_stats(const struct device *dev);
+
+/**
+ * @brief Get motion delta saturation statistics
+ *
+ * Copies the number of samples whose deltas were clipped at the 8-bit
+ * limit and the number of times the driver lowered the hardware CPI in
+ * response (see CONFIG_PAW3222_SATURATION_CPI_STEPS).
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param stats Pointer to store the statistics (must not be NULL)
+ *
+ * @return 0 on success
+ */
+int paw32xx_get_saturation_stats(const struct device *dev,
+                                 struct paw32xx_saturation_stats *stats);
+
+/**
+ * @brief Reset motion delta saturation statistics
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ */
+void paw32xx_reset_saturation_stats(const struct device *dev);
+
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+/**
+ * @brief Get motion latency histograms
+ *
+ * Copies the per-stage latency histograms. Each input report sent adds the
+ * timings of the latest motion sample folded into it, so samples merged by
+ * report coalescing are counted once. See enum paw32xx_latency_stage for the
+ * measured stages.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param stats Pointer to store the histograms (must not be NULL)
+ *
+ * @return 0 on success
+ */
+int paw32xx_get_latency_stats(const struct device *dev,
+                              struct paw32xx_latency_stats *stats);
+
+/**
+ * @brief Reset motion latency histograms
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ */
+void paw32xx_reset_latency_stats(const struct device *dev);
+#endif
+
+#ifdef CONFIG_PAW3222_QUEUE_WAIT_STATS
+/**
+ * @brief Get motion work queue-wait statistics
+ *
+ * Copies the time motion work spent queued between submission (from the
+ * motion interrupt or the poll timer) and the start of the work handler.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param stats Pointer to store the statistics (must not be NULL)
+ *
+ * @return 0 on success
+ */
+int paw32xx_get_queue_wait_stats(const struct device *dev,
+                                 struct paw32xx_queue_wait_stats *stats);
+
+/**
+ * @brief Reset motion work queue-wait statistics
  *
  * @param dev PAW3222 device pointer (must not be NULL)
- * 
- * @note This function is called automatically during device initialization
- *       when CONFIG_PAW3222_BEHAVIOR is enabled. It should not be called
- *       directly by application code.
- * 
- * @warning Only one PAW3222 device instance is supported when using behaviors.
  */
-void paw32xx_set_device_reference(const struct device *dev);
+void paw32xx_reset_queue_wait_stats(const struct device *dev);
+#endif
+
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+/**
+ * @brief Dynamic force-awake work handler
+ *
+ * Enables force-awake while motion is ongoing or a snipe, scroll or
+ * awake-layers layer is active, and lets the sensor sleep again once none
+ * of these holds, awake-idle-ms after it was queued.
+ *
+ * @param work Pointer to the awake_work item (must not be NULL)
+ */
+void paw32xx_awake_work_handler(struct k_work *work);
+
+/**
+ * @brief Queue the force-awake transition the current activity calls for
+ *
+ * Wakes the sensor right away when motion, the input mode or an
+ * awake-layers layer asks for it, and lets it sleep again awake-idle-ms
+ * after none does. Does nothing when the sensor is already in that state.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ */
+void paw32xx_awake_update(const struct device *dev);
+#endif
+
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+/**
+ * @brief Get runtime PM statistics
+ *
+ * Copies the resume and auto-suspend counters and the resume-to-first-report
+ * latencies measured since the last reset.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param stats Pointer to store the statistics (must not be NULL)
+ *
+ * @return 0 on success
+ */
+int paw32xx_get_pm_stats(const struct device *dev, struct paw32xx_pm_stats *stats);
+
+/**
+ * @brief Reset runtime PM statistics
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ */
+void paw32xx_reset_pm_stats(const struct device *dev);
+
+/**
+ * @brief Auto-suspend work handler
+ *
+ * Scheduled autosuspend-ms after motion stops and releases the runtime PM
+ * reference the motion path took when motion started.
+ *
+ * @param work Pointer to the pm_suspend_work item (must not be NULL)
+ */
+void paw32xx_pm_suspend_work_handler(struct k_work *work);
 #endif
 
 /**
@@ -74,17 +318,96 @@ void paw32xx_set_device_reference(const struct device *dev);
  */
 void paw32xx_motion_timer_handler(struct k_timer *timer);
 
+/**
+ * @brief Turn one motion sample into input events
+ *
+ * The sensor independent part of the motion path, shared by
+ * paw32xx_motion_work_handler() and the trace replay harness:
+ * - Applies coordinate transformations based on sensor rotation
+ * - Applies the pointer acceleration table in move mode (CONFIG_PAW3222_ACCEL)
+ * - Applies the snipe divisors and scroll accumulation of the mode
+ * - Generates input events (cursor movement, scroll wheel, etc.), coalesced
+ *   to one report per coalesce-us window when configured
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param input_mode Input mode to process the sample in
+ * @param x X delta at the target CPI of the mode
+ * @param y Y delta at the target CPI of the mode
+ * @param time_us Sample timestamp in microseconds, used by acceleration
+ *
+ * @note Given the same driver state and samples, the emitted events are
+ *       identical; with coalescing disabled nothing depends on wall time.
+ */
+void paw32xx_process_sample(const struct device *dev, enum paw32xx_input_mode input_mode,
+                            int16_t x, int16_t y, uint32_t time_us);
+
+#ifdef CONFIG_PAW3222_TRACE
+/**
+ * @brief Start or stop recording motion samples
+ *
+ * Recording is on from boot. Stopping keeps the recorded samples.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param enable true to record new samples
+ */
+void paw32xx_trace_enable(const struct device *dev, bool enable);
+
+/**
+ * @brief Drop all recorded motion samples
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ */
+void paw32xx_trace_clear(const struct device *dev);
+
+/**
+ * @brief Get the number of motion samples held in the trace ring
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ *
+ * @return Number of entries, at most CONFIG_PAW3222_TRACE_ENTRIES
+ */
+size_t paw32xx_trace_len(const struct device *dev);
+
+/**
+ * @brief Get a recorded motion sample
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param index Entry index, 0 is the oldest sample held
+ * @param entry Pointer to store the sample (must not be NULL)
+ *
+ * @return 0 on success, -ENOENT if index is past the newest sample
+ */
+int paw32xx_trace_get(const struct device *dev, size_t index,
+                      struct paw32xx_trace_entry *entry);
+
+/**
+ * @brief Dump the recorded motion samples to the log
+ *
+ * Logs one PAW32XX_TRACE_FMT line per sample, oldest first, with recording
+ * paused for the duration of the dump.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ *
+ * @note With deferred logging a large trace may overflow the log buffer;
+ *       the "paw3222 trace" shell command prints without that limit.
+ */
+void paw32xx_trace_log(const struct device *dev);
+#endif
+
 /**
  * @brief Motion work queue handler - processes sensor data
  *
  * This is the main motion processing function that reads motion data from
  * the PAW3222 sensor and generates appropriate input events. The function:
- * - Reads motion status and X/Y delta values from the sensor
- * - Determines the current input mode (move, scroll, snipe, etc.)
- * - Applies coordinate transformations based on sensor rotation
- * - Handles CPI switching for different modes
- * - Generates input events (cursor movement, scroll wheel, etc.)
- * - Manages scroll accumulation for smooth scrolling
+ * - Reads motion status and X/Y delta values from the sensor in a single
+ *   burst SPI transaction
+ * - Uses the input mode (move, scroll, snipe, etc.) cached by
+ *   paw32xx_update_input_mode()
+ * - Rescales deltas to the target CPI while a CPI change is still pending
+ *   or the hardware CPI is lowered to avoid delta saturation
+ * - Detects saturated deltas and polls faster or lowers the hardware CPI
+ * - Records the sample in the motion trace (CONFIG_PAW3222_TRACE)
+ * - Hands the sample to paw32xx_process_sample()
  *
  * @param work Pointer to the work item being processed (must not be NULL)
  * 
@@ -97,6 +420,33 @@ void paw32xx_motion_timer_handler(struct k_timer *timer);
  */
 void paw32xx_motion_work_handler(struct k_work *work);
 
+/**
+ * @brief CPI work queue handler - applies the cached target CPI
+ *
+ * Writes data->target_cpi, halved once per active saturation CPI
+ * reduction, to the sensor CPI registers when it differs from the
+ * currently configured value. Submitted by paw32xx_update_input_mode()
+ * on the motion workqueue, so CPI changes happen once per mode change instead
+ * of being checked on every motion sample.
+ *
+ * @param work Pointer to the work item being processed (must not be NULL)
+ *
+ * @note Motion samples processed before this handler runs are rescaled to
+ *       the target CPI by paw32xx_motion_work_handler().
+ */
+void paw32xx_cpi_work_handler(struct k_work *work);
+
+/**
+ * @brief Parameter work queue handler - applies staged motion parameters
+ *
+ * Copies the parameters staged by paw32xx_set_params() to data->params and
+ * calls paw32xx_update_input_mode(). Runs on the motion workqueue, so no
+ * motion sample sees a partially updated parameter set.
+ *
+ * @param work Pointer to the work item being processed (must not be NULL)
+ */
+void paw32xx_params_work_handler(struct k_work *work);
+
 /**
  * @brief GPIO interrupt handler for motion detection
  *
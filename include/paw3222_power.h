@@ -14,14 +14,70 @@
 #include <zephyr/device.h>
 #include <zephyr/pm/device.h>
 
+#include "paw3222.h"
+
+/**
+ * @brief Check whether a PAW3222 has finished initializing
+ *
+ * device_is_ready() only covers the init hook. With
+ * CONFIG_PAW3222_ASYNC_INIT the sensor is configured later from a work
+ * item, and the driver APIs fail until this returns true, see
+ * paw32xx_ready_status().
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ *
+ * @return true once the sensor has been configured
+ */
+bool paw32xx_is_ready(const struct device *dev);
+
+/**
+ * @brief Check whether the sensor supply is on
+ *
+ * A power-gated sensor is switched off by PM suspend. Driver work items
+ * check this and do nothing while it is false, so a submission that races
+ * with suspend never touches the unpowered sensor.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ *
+ * @return false between a power-gating suspend and the matching resume
+ */
+bool paw32xx_is_powered(const struct device *dev);
+
+/**
+ * @brief Get the error a driver API returns for the current bring-up state
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ *
+ * @return 0 once the sensor has been configured
+ * @retval -EAGAIN Deferred initialization is still running
+ * @retval -EIO Sensor bring-up failed, the sensor will not become ready
+ */
+int paw32xx_ready_status(const struct device *dev);
+
+/**
+ * @brief Wait for a freshly powered PAW3222 to answer on SPI
+ *
+ * Sleeps for @p min_ms, then polls PRODUCT_ID1 every READY_POLL_US until it
+ * reads PRODUCT_ID_PAW32XX or the ready-timeout-ms bound expires.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param min_ms Minimum delay before the first read, 0 to poll immediately
+ *
+ * @return 0 on success, negative error code on failure
+ * @retval -ETIMEDOUT The product ID did not match within the timeout
+ * @retval -EIO SPI communication failure on the last read
+ */
+int paw32xx_wait_ready(const struct device *dev, uint32_t min_ms);
+
 /**
  * @brief Configure and initialize the PAW3222 sensor
  *
  * Performs initial configuration of the PAW3222 sensor including:
  * - Verifying the product ID to ensure proper sensor communication
  * - Performing a software reset of the sensor
- * - Setting the initial CPI resolution if configured
- * - Configuring force awake mode if enabled
+ * - Writing the initial CPI resolution (if configured), the power profile
+ *   sleep timing and the force awake mode in a single write-protect window
+ *   and SPI transaction
  * - Validating configuration parameters
  *
  * @param dev PAW3222 device pointer (must not be NULL)
@@ -47,9 +103,8 @@ int paw32xx_configure(const struct device *dev);
  * the sensitivity of cursor movement. Higher CPI values result in more
  * sensitive movement. The function:
  * - Validates the CPI value is within hardware limits
- * - Disables write protection on the sensor
- * - Updates both X and Y CPI registers
- * - Re-enables write protection
+ * - Updates both X and Y CPI registers inside one write-protect window,
+ *   sent as a single SPI transaction (see paw32xx_write_seq())
  *
  * @param dev PAW3222 device pointer (must not be NULL)
  * @param res_cpi CPI resolution value (range: 608-4826)
@@ -60,11 +115,16 @@ int paw32xx_configure(const struct device *dev);
  * @retval 0 CPI set successfully
  * @retval -EINVAL CPI value is out of valid range (< 608 or > 4826)
  * @retval -EIO SPI communication failure during register access
+ * @retval -EAGAIN The sensor has not finished initializing
+ * @retval -EIO Sensor bring-up failed
  * 
  * @note This function can be called at runtime to dynamically adjust
  *       sensor sensitivity. The driver automatically switches CPI for
  *       different input modes (normal vs snipe).
  * 
+ * @note No bus traffic is generated when the register shadow shows the
+ *       requested CPI is already configured.
+ *
  * @warning Changing CPI affects all subsequent motion readings until
  *          changed again or device reset.
  */
@@ -86,16 +146,45 @@ int paw32xx_set_resolution(const struct device *dev, uint16_t res_cpi);
  * @return 0 on success, negative error code on failure
  * @retval 0 Force awake mode set successfully
  * @retval -EIO SPI communication failure during register access
+ * @retval -EAGAIN The sensor has not finished initializing
+ * @retval -EIO Sensor bring-up failed
  * 
  * @note This setting affects power consumption vs response time trade-off:
  *       - Force awake ON: Lower latency, higher power consumption
  *       - Force awake OFF: Higher latency, lower power consumption
  * 
  * @note This function can be called at runtime to dynamically adjust
- *       power management behavior based on usage patterns.
+ *       power management behavior based on usage patterns. The write-protect
+ *       unlock, OPERATION_MODE write and lock go out in a single SPI
+ *       transaction.
+ *
+ * @note No bus traffic is generated when the register shadow shows the
+ *       sensor is already in the requested state.
  */
 int paw32xx_force_awake(const struct device *dev, bool enable);
 
+/**
+ * @brief Select the sleep power profile of a PAW3222 device
+ *
+ * Programs the SLEEP1..SLEEP3 entry times and frame rates of the profile
+ * and the sleep modes the sensor may enter while force awake is off. The
+ * force awake state itself is kept.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param profile Power profile to apply
+ *
+ * @return 0 on success, negative error code on failure
+ * @retval 0 Power profile applied
+ * @retval -EINVAL Unknown power profile
+ * @retval -EIO SPI communication failure during register access
+ * @retval -EAGAIN The sensor has not finished initializing
+ * @retval -EIO Sensor bring-up failed
+ *
+ * @note The changed registers go out in a single SPI transaction; none
+ *       when the profile is already active.
+ */
+int paw32xx_set_power_profile(const struct device *dev, enum paw32xx_power_profile profile);
+
 #ifdef CONFIG_PM_DEVICE
 /**
  * @brief Power management action handler
@@ -117,12 +206,26 @@ int paw32xx_force_awake(const struct device *dev, bool enable);
  * @retval 0 Power management action completed successfully
  * @retval -ENOTSUP Unsupported power management action
  * @retval -EIO SPI communication failure during power state change
+ * @retval -EBUSY The sensor has not finished initializing
+ * @retval -EIO Sensor bring-up failed
  * 
  * @note This function is called automatically by the power management
  *       subsystem and should not be called directly by application code.
  * 
- * @note If power-gpios is configured in device tree, this function will
- *       also control the external power supply to the sensor.
+ * @note While the device is enabled as a wakeup source (done at init with
+ *       CONFIG_PAW3222_PM_AUTOSUSPEND), suspend only releases force-awake
+ *       so the sensor keeps detecting motion in its sleep modes, and resume
+ *       restores the force-awake state: the one the current activity asks
+ *       for with CONFIG_PAW3222_DYNAMIC_AWAKE, the force-awake property
+ *       otherwise. power-gpios is never switched in this case, as a gated
+ *       sensor could not detect the motion that resumes it.
+ *
+ * @note Otherwise, if the instance has a power-gpios property, suspend also
+ *       cuts the sensor supply and stops motion polling, and resume powers
+ *       it back up and rewrites the full configuration, since the sensor
+ *       restarts with reset defaults. Each instance is gated independently.
+ *       As CONFIG_PAW3222_PM_AUTOSUSPEND requires wakeup-source, this only
+ *       applies to system suspend without auto-suspend.
  */
 int paw32xx_pm_action(const struct device *dev, enum pm_device_action action);
 #endif
@@ -86,6 +86,19 @@
 
 /** @} */
 
+/**
+ * @defgroup PAW3222_SLEEP_BITS Sleep Register Bit Definitions
+ * @brief Bit field definitions for PAW32XX_SLEEP1..PAW32XX_SLEEP3 registers
+ * @{
+ */
+
+/** @brief Frame period while in the sleep mode - larger values sample less often */
+#define SLEEP_FREQ_MASK GENMASK(7, 4)
+/** @brief Idle time before entering the sleep mode - larger values enter later */
+#define SLEEP_ETM_MASK GENMASK(3, 0)
+
+/** @} */
+
 /**
  * @defgroup PAW3222_CONFIGURATION_BITS Configuration Register Bit Definitions
  * @brief Bit field definitions for PAW32XX_CONFIGURATION register
@@ -122,6 +135,8 @@
 #define PAW32XX_DATA_SIZE_BITS 8
 /** @brief Required delay in milliseconds after sensor reset */
 #define RESET_DELAY_MS 2
+/** @brief Interval in microseconds between product ID reads while waiting for power-up */
+#define READY_POLL_US 500
 
 /** @} */
 
@@ -9,9 +9,22 @@
 #ifndef PAW3222_SPI_H_
 #define PAW3222_SPI_H_
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <zephyr/device.h>
 
+/** Maximum number of register writes in one paw32xx_write_seq() call */
+#define PAW32XX_WRITE_SEQ_MAX 8
+
+/**
+ * @brief Register write entry for paw32xx_write_seq()
+ */
+struct paw32xx_reg_write {
+  uint8_t addr;  /**< Register address (without the SPI write bit) */
+  uint8_t value; /**< Value to write */
+};
+
 /**
  * @brief Read a register from the PAW3222 sensor via SPI
  *
@@ -68,10 +81,10 @@ int paw32xx_write_reg(const struct device *dev, uint8_t addr, uint8_t value);
  * configuration flags without affecting other settings in the same register.
  *
  * The operation sequence is:
- * 1. Read the current register value
+ * 1. Read the current register value (from the register shadow if valid)
  * 2. Clear bits specified by mask
  * 3. Set new bits from value (masked)
- * 4. Write the modified value back
+ * 4. Write the modified value back, unless it is unchanged
  *
  * @param dev PAW3222 device pointer (must not be NULL)
  * @param addr Register address to update (valid range: 0x00-0x0E)
@@ -93,6 +106,87 @@ int paw32xx_write_reg(const struct device *dev, uint8_t addr, uint8_t value);
  */
 int paw32xx_update_reg(const struct device *dev, uint8_t addr, uint8_t mask, uint8_t value);
 
+/**
+ * @brief Write a sequence of registers inside one write-protect window
+ *
+ * Sends the write-protect unlock, every (addr, value) pair of the sequence
+ * and the write-protect lock as a single multi-buffer SPI transaction.
+ * Entries whose shadowed value already matches are left out; when nothing
+ * is left to write no bus traffic is generated at all.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param seq Register writes, applied in order (must not be NULL)
+ * @param len Number of entries in seq (at most PAW32XX_WRITE_SEQ_MAX)
+ *
+ * @return 0 on success, negative error code on failure
+ * @retval 0 Sequence written successfully (or nothing to write)
+ * @retval -EINVAL Sequence longer than PAW32XX_WRITE_SEQ_MAX
+ * @retval -EIO SPI communication failure or transaction error
+ *
+ * @note The register shadow is updated on success. On failure every
+ *       register of the sequence is marked as unknown.
+ */
+int paw32xx_write_seq(const struct device *dev, const struct paw32xx_reg_write *seq, size_t len);
+
+/**
+ * @brief Take the sensor bus lock
+ *
+ * Serializes SPI transactions and register shadow updates between the
+ * driver workqueue and other threads such as the shell. Every register
+ * access function takes it internally; take it around a sequence that must
+ * not interleave with other bus users, such as a shadow read followed by a
+ * write. The lock is recursive.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ */
+void paw32xx_bus_lock(const struct device *dev);
+
+/**
+ * @brief Release the sensor bus lock taken with paw32xx_bus_lock()
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ */
+void paw32xx_bus_unlock(const struct device *dev);
+
+/**
+ * @brief Get a register value from the register shadow
+ *
+ * The driver mirrors the writable configuration registers (OPERATION_MODE,
+ * CONFIGURATION, SLEEP1-3, CPI_X/Y) in its runtime data. The shadow is
+ * updated on every register read and write and invalidated on reset.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param addr Register address
+ * @param value Pointer to store the shadowed value (must not be NULL)
+ *
+ * @return true if the register is shadowed and its shadow is valid,
+ *         false otherwise (value is left untouched)
+ */
+bool paw32xx_shadow_get(const struct device *dev, uint8_t addr, uint8_t *value);
+
+/**
+ * @brief Reload the register shadow from the sensor
+ *
+ * Reads all shadowed registers in a single SPI transaction. Called after
+ * a sensor reset so later read-modify-write updates can skip the bus read.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ *
+ * @return 0 on success, negative error code on failure
+ * @retval -EIO SPI communication failure
+ */
+int paw32xx_shadow_refresh(const struct device *dev);
+
+/**
+ * @brief Mark the whole register shadow as stale
+ *
+ * Must be called whenever the sensor may have lost its register state
+ * without the driver writing it, e.g. after cutting its power.
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ */
+void paw32xx_shadow_invalidate(const struct device *dev);
+
 /**
  * @brief Read X and Y motion delta values from the PAW3222 sensor
  *
@@ -127,4 +221,30 @@ int paw32xx_update_reg(const struct device *dev, uint8_t addr, uint8_t mask, uin
  */
 int paw32xx_read_xy(const struct device *dev, int16_t *x, int16_t *y);
 
+/**
+ * @brief Read motion status and X/Y deltas in a single SPI transaction
+ *
+ * Fetches PAW32XX_MOTION, PAW32XX_DELTA_X and PAW32XX_DELTA_Y back to back
+ * under one chip-select assertion, so that each motion sample costs one bus
+ * transaction instead of one for the status register and one for the deltas.
+ * The deltas are sign-extended the same way as paw32xx_read_xy().
+ *
+ * @param dev PAW3222 device pointer (must not be NULL)
+ * @param motion Pointer to store the raw motion status register (must not be NULL)
+ * @param x Pointer to store X delta value (must not be NULL)
+ *          Range: -128 to +127 (8-bit signed, extended to 16-bit)
+ * @param y Pointer to store Y delta value (must not be NULL)
+ *          Range: -128 to +127 (8-bit signed, extended to 16-bit)
+ *
+ * @return 0 on success, negative error code on failure
+ * @retval 0 Motion status and data read successfully
+ * @retval -ENODEV SPI device is not ready or not available
+ * @retval -EIO SPI communication failure or transaction error
+ *
+ * @note Reading the delta registers clears them in the sensor, so the deltas
+ *       are consumed even when the caller ignores them because
+ *       MOTION_STATUS_MOTION is not set.
+ */
+int paw32xx_read_motion_burst(const struct device *dev, uint8_t *motion, int16_t *x, int16_t *y);
+
 #endif /* PAW3222_SPI_H_ */
\ No newline at end of file
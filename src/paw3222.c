@@ -7,6 +7,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 #include <zephyr/device.h>
 #include <zephyr/devicetree.h>
@@ -17,10 +18,13 @@
 #include <zephyr/pm/device.h>
 #include <zephyr/pm/device_runtime.h>
 #include <zephyr/sys/util_macro.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/layer_state_changed.h>
 
 #include "paw3222.h"
 #include "paw3222_input.h"
 #include "paw3222_power.h"
+#include "paw3222_regs.h"
 
 LOG_MODULE_REGISTER(paw32xx, CONFIG_ZMK_LOG_LEVEL);
 
@@ -28,6 +32,126 @@ LOG_MODULE_REGISTER(paw32xx, CONFIG_ZMK_LOG_LEVEL);
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
+/**
+ * @brief Bring up a powered PAW3222 and start motion processing
+ *
+ * Enables the supply of a gated sensor, waits for the product ID, writes
+ * the configuration and only then arms the motion interrupt and runtime PM.
+ * The device is flagged ready (see paw32xx_is_ready()) once configured.
+ *
+ * @param dev PAW3222 device instance
+ *
+ * @return 0 on success, negative error code on failure
+ */
+static int paw32xx_start(const struct device *dev)
+{
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  uint32_t min_ms = 0;
+  int64_t ready_start;
+  int ret;
+
+  if (cfg->power_gpio.port != NULL)
+  {
+    ret = gpio_pin_set_dt(&cfg->power_gpio, 1);
+    if (ret != 0)
+    {
+      LOG_ERR("Power pin set failed: %d", ret);
+      return ret;
+    }
+    min_ms = cfg->power_on_ms;
+  }
+
+  // Poll the product ID instead of sleeping for the worst-case power-up time
+  ready_start = k_uptime_get();
+  ret = paw32xx_wait_ready(dev, min_ms);
+  if (ret != 0)
+  {
+    LOG_ERR("Sensor did not come up: %d", ret);
+    return ret;
+  }
+  data->boot.ready_ms = (uint32_t)(k_uptime_get() - ready_start);
+
+  ret = paw32xx_configure(dev);
+  if (ret != 0)
+  {
+    LOG_ERR("Device configuration failed: %d", ret);
+    gpio_remove_callback_dt(&cfg->irq_gpio, &data->motion_cb);
+    return ret;
+  }
+
+  // Apply mode changes skipped while the sensor was coming up. This sets
+  // target_cpi, which motion work needs as soon as the interrupt is armed.
+  atomic_set(&data->init_state, PAW32XX_INIT_DONE);
+  paw32xx_update_input_mode(dev);
+
+  ret =
+      gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+  if (ret != 0)
+  {
+    LOG_ERR("Motion interrupt configuration failed: %d", ret);
+    gpio_remove_callback_dt(&cfg->irq_gpio, &data->motion_cb);
+    return ret;
+  }
+
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+  // Runtime suspend keeps the motion interrupt armed, see paw32xx_pm_action()
+  pm_device_wakeup_enable(dev, true);
+#endif
+
+#if defined(CONFIG_PM_DEVICE_RUNTIME) && !defined(CONFIG_PAW3222_PM_AUTOSUSPEND)
+  // Enabling runtime PM would suspend the configured sensor (cutting a gated
+  // supply) only for the reference below to bring it up again. Mark it
+  // suspended instead; the resume then finds it powered and does nothing.
+  pm_device_init_suspended(dev);
+#endif
+
+  // Enabling runtime PM suspends the device until the first reference is taken
+  ret = pm_device_runtime_enable(dev);
+  if (ret < 0)
+  {
+    LOG_ERR("Failed to enable runtime power management: %d", ret);
+    gpio_remove_callback_dt(&cfg->irq_gpio, &data->motion_cb);
+    gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_DISABLE);
+    return ret;
+  }
+
+#if defined(CONFIG_PM_DEVICE_RUNTIME) && !defined(CONFIG_PAW3222_PM_AUTOSUSPEND)
+  // Nothing releases the sensor without auto-suspend, so keep it active
+  ret = pm_device_runtime_get(dev);
+  if (ret < 0)
+  {
+    LOG_ERR("Failed to resume device: %d", ret);
+    return ret;
+  }
+#endif
+
+  data->boot.init_done_ms = MAX(k_uptime_get_32(), 1);
+  LOG_INF("%s ready in %u ms, init done at %u ms", dev->name, data->boot.ready_ms,
+          data->boot.init_done_ms);
+
+  return 0;
+}
+
+#ifdef CONFIG_PAW3222_ASYNC_INIT
+// Deferred sensor bring-up, scheduled by paw32xx_init()
+static void paw32xx_init_work_handler(struct k_work *work)
+{
+  struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+  struct paw32xx_data *data = CONTAINER_OF(dwork, struct paw32xx_data, init_work);
+  int ret;
+
+  ret = paw32xx_start(data->dev);
+  if (ret != 0)
+  {
+    // Nothing retries a sensor that is absent or broken, so make the driver
+    // APIs and the shell report the failure instead of -EAGAIN forever
+    LOG_ERR("%s: deferred initialization failed: %d", data->dev->name, ret);
+    atomic_set(&data->init_state, PAW32XX_INIT_FAILED);
+  }
+}
+#endif
+
 /**
  * @brief Initialize the PAW3222 device
  *
@@ -35,10 +159,14 @@ LOG_MODULE_REGISTER(paw32xx, CONFIG_ZMK_LOG_LEVEL);
  * - SPI interface validation
  * - GPIO configuration for motion interrupt and power control
  * - Work queue and timer initialization
- * - Sensor hardware configuration and validation
+ * - Sensor hardware configuration and validation (see paw32xx_start())
  * - Power management setup
  * - Interrupt configuration
  *
+ * With CONFIG_PAW3222_ASYNC_INIT the sensor bring-up is deferred to a work
+ * item and this returns as soon as the GPIOs are set up. The device then
+ * reports ready through paw32xx_is_ready() only.
+ *
  * @param dev PAW3222 device instance to initialize
  * 
  * @return 0 on success, negative error code on failure
@@ -54,11 +182,53 @@ static int paw32xx_init(const struct device *dev)
 {
   const struct paw32xx_config *cfg = dev->config;
   struct paw32xx_data *data = dev->data;
+  k_timeout_t power_off = K_NO_WAIT;
   int ret;
 
   data->current_cpi = -1;                 // Initialize to invalid value to ensure CPI is set on first use
+  k_mutex_init(&data->bus_lock);          // Shared by the workqueue, shell and PM callers
+  data->reg_shadow_valid = 0;             // Nothing is known until the sensor is reset and read back
+  data->sleep_defaults_valid = false;     // Captured by the first paw32xx_configure()
+  data->power_profile = cfg->power_profile;
+  data->force_awake_active = false;
   data->scroll_accumulator = 0;           // Initialize scroll accumulator
+  data->poll_interval_us = 0;             // Idle until the first motion interrupt
+  data->snipe_remainder_x = 0;
+  data->snipe_remainder_y = 0;
+  data->scroll_snipe_remainder = 0;
+  data->cpi_remainder_x = 0;
+  data->cpi_remainder_y = 0;
+  data->cpi_reduction = 0;                // Full CPI until deltas saturate
   data->current_mode = PAW32XX_MODE_MOVE; // Initialize to move mode
+  data->params = (struct paw32xx_params){
+      .res_cpi = cfg->res_cpi,
+      .snipe_cpi = cfg->snipe_cpi,
+      .snipe_divisor = cfg->snipe_divisor,
+      .scroll_snipe_divisor = cfg->scroll_snipe_divisor,
+      .scroll_tick = cfg->scroll_tick,
+      .scroll_snipe_tick = cfg->scroll_snipe_tick,
+      .rotation = cfg->rotation,
+      .coalesce_us = cfg->coalesce_us,
+  };
+  data->pending_params = data->params;
+  memset(&data->stats, 0, sizeof(data->stats));
+  memset(&data->boot, 0, sizeof(data->boot));
+  atomic_set(&data->init_state, PAW32XX_INIT_PENDING); // Until paw32xx_start() finishes
+#ifdef CONFIG_PM_DEVICE
+  atomic_set(&data->powered_off, 0);
+#endif
+  memset(data->report_pending, 0, sizeof(data->report_pending));
+  data->report_window_open = false;
+#ifdef CONFIG_PAW3222_ACCEL
+  paw32xx_accel_build_lut(&cfg->accel, data->accel_lut);
+  data->accel_remainder_x = 0;
+  data->accel_remainder_y = 0;
+  data->accel_last_us = k_cyc_to_us_floor32(k_cycle_get_32());
+#endif
+#ifdef CONFIG_PAW3222_TRACE
+  data->trace_count = 0;
+  data->trace_enabled = true;
+#endif
   data->mode_toggle_state = false;
 
   if (!spi_is_ready_dt(&cfg->spi))
@@ -69,33 +239,39 @@ static int paw32xx_init(const struct device *dev)
 
   data->dev = dev;
 
-// Set device reference for behavior (if enabled)
-#ifdef CONFIG_PAW3222_BEHAVIOR
-  paw32xx_set_device_reference(dev);
-#endif
-
   k_work_init(&data->motion_work, paw32xx_motion_work_handler);
+  k_work_init(&data->cpi_work, paw32xx_cpi_work_handler);
+  k_work_init(&data->params_work, paw32xx_params_work_handler);
+  k_work_init_delayable(&data->report_work, paw32xx_report_work_handler);
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+  k_work_init_delayable(&data->awake_work, paw32xx_awake_work_handler);
+  data->awake_hold = false;
+#endif
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+  k_work_init_delayable(&data->pm_suspend_work, paw32xx_pm_suspend_work_handler);
+  data->pm_active = false;
+  data->pm_wake_pending = false;
+  memset(&data->pm, 0, sizeof(data->pm));
+#endif
   k_timer_init(&data->motion_timer, paw32xx_motion_timer_handler, NULL);
 
-#if DT_INST_NODE_HAS_PROP(0, power_gpios)
-  if (gpio_is_ready_dt(&cfg->power_gpio))
+  // Each instance gates its own supply when it has a power-gpios property
+  if (cfg->power_gpio.port != NULL)
   {
-    ret = gpio_pin_configure_dt(&cfg->power_gpio, GPIO_OUTPUT_INACTIVE);
-    if (ret != 0)
+    if (!gpio_is_ready_dt(&cfg->power_gpio))
     {
-      LOG_ERR("Power pin configuration failed: %d", ret);
-      return ret;
+      LOG_ERR("%s is not ready", cfg->power_gpio.port->name);
+      return -ENODEV;
     }
-    k_sleep(K_MSEC(500));
-    ret = gpio_pin_set_dt(&cfg->power_gpio, 1);
+
+    ret = gpio_pin_configure_dt(&cfg->power_gpio, GPIO_OUTPUT_INACTIVE);
     if (ret != 0)
     {
-      LOG_ERR("Power pin set failed: %d", ret);
+      LOG_ERR("Power pin configuration failed: %d", ret);
       return ret;
     }
-    k_sleep(K_MSEC(10));
+    power_off = K_MSEC(cfg->power_off_ms); // Let the supply discharge for a clean power cycle
   }
-#endif
 
   if (!gpio_is_ready_dt(&cfg->irq_gpio))
   {
@@ -120,92 +296,72 @@ static int paw32xx_init(const struct device *dev)
     return ret;
   }
 
-  ret = paw32xx_configure(dev);
-  if (ret != 0)
-  {
-    LOG_ERR("Device configuration failed: %d", ret);
-    gpio_remove_callback_dt(&cfg->irq_gpio, &data->motion_cb);
-    return ret;
-  }
+#ifdef CONFIG_PAW3222_ASYNC_INIT
+  // Keys and other devices start while the sensor comes up in parallel
+  k_work_init_delayable(&data->init_work, paw32xx_init_work_handler);
+  paw32xx_schedule_work(&data->init_work, power_off);
 
-  ret =
-      gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_EDGE_TO_ACTIVE);
-  if (ret != 0)
-  {
-    LOG_ERR("Motion interrupt configuration failed: %d", ret);
-    gpio_remove_callback_dt(&cfg->irq_gpio, &data->motion_cb);
-    return ret;
-  }
+  return 0;
+#else
+  k_sleep(power_off);
 
-  ret = pm_device_runtime_enable(dev);
-  if (ret < 0)
+  ret = paw32xx_start(dev);
+  if (ret != 0)
   {
-    LOG_ERR("Failed to enable runtime power management: %d", ret);
-    gpio_remove_callback_dt(&cfg->irq_gpio, &data->motion_cb);
-    gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_DISABLE);
-    return ret;
+    atomic_set(&data->init_state, PAW32XX_INIT_FAILED);
   }
 
-  return 0;
+  return ret;
+#endif
 }
 
 #define PAW32XX_SPI_MODE                                                  \
   (SPI_OP_MODE_MASTER | SPI_WORD_SET(8) | SPI_MODE_CPOL | SPI_MODE_CPHA | \
    SPI_TRANSFER_MSB)
 
+/*
+ * Layer-to-mode table, resolved at build time from the *-layers properties.
+ * Each layer maps to the highest priority mode listing it, in the same order
+ * the layer arrays used to be scanned. Layers beyond PAW32XX_MAX_LAYERS are
+ * ignored since ZMK cannot activate them.
+ */
+#define PAW32XX_LAYER_BIT(node_id, prop, idx)                                               \
+  ((DT_PROP_BY_IDX(node_id, prop, idx) < PAW32XX_MAX_LAYERS)                                \
+       ? BIT(DT_PROP_BY_IDX(node_id, prop, idx) & (PAW32XX_MAX_LAYERS - 1))                 \
+       : 0)
+
+#define PAW32XX_LAYER_MASK(n, prop)                                                         \
+  COND_CODE_1(DT_INST_NODE_HAS_PROP(n, prop),                                               \
+              ((DT_INST_FOREACH_PROP_ELEM_SEP(n, prop, PAW32XX_LAYER_BIT, (|)))), (0U))
+
+#define PAW32XX_LAYER_MODE(n, layer)                                                        \
+  ((PAW32XX_LAYER_MASK(n, scroll_horizontal_snipe_layers) & BIT(layer))                     \
+       ? PAW32XX_SCROLL_HORIZONTAL_SNIPE                                                    \
+   : (PAW32XX_LAYER_MASK(n, scroll_snipe_layers) & BIT(layer))                              \
+       ? PAW32XX_SCROLL_SNIPE                                                               \
+   : (PAW32XX_LAYER_MASK(n, scroll_horizontal_layers) & BIT(layer))                         \
+       ? PAW32XX_SCROLL_HORIZONTAL                                                          \
+   : (PAW32XX_LAYER_MASK(n, scroll_layers) & BIT(layer)) ? PAW32XX_SCROLL                   \
+   : (PAW32XX_LAYER_MASK(n, snipe_layers) & BIT(layer))  ? PAW32XX_SNIPE                    \
+                                                         : PAW32XX_MOVE)
+
+#define PAW32XX_LAYER_MODE_PAIR(i, n)                                                       \
+  (PAW32XX_LAYER_MODE(n, 2 * (i)) | (PAW32XX_LAYER_MODE(n, 2 * (i) + 1) << 4))
+
+// CONFIG_PAW3222_PM_AUTOSUSPEND_MS only exists with auto-suspend enabled
+#define PAW32XX_AUTOSUSPEND_MS_DEFAULT                                                      \
+  COND_CODE_1(CONFIG_PAW3222_PM_AUTOSUSPEND, (CONFIG_PAW3222_PM_AUTOSUSPEND_MS), (0))
+
+// CONFIG_PAW3222_AWAKE_IDLE_MS only exists with dynamic force-awake enabled
+#define PAW32XX_AWAKE_IDLE_MS_DEFAULT                                                       \
+  COND_CODE_1(CONFIG_PAW3222_DYNAMIC_AWAKE, (CONFIG_PAW3222_AWAKE_IDLE_MS), (0))
+
 #define PAW32XX_INIT(n)                                                                     \
-  COND_CODE_1(                                                                              \
-      DT_INST_NODE_HAS_PROP(n, scroll_layers),                                              \
-      (static int32_t scroll_layers##n[] = DT_INST_PROP(n, scroll_layers);),                \
-      (/* Do nothing */))                                                                   \
-  COND_CODE_1(                                                                              \
-      DT_INST_NODE_HAS_PROP(n, snipe_layers),                                               \
-      (static int32_t snipe_layers##n[] = DT_INST_PROP(n, snipe_layers);),                  \
-      (/* Do nothing */))                                                                   \
-  COND_CODE_1(DT_INST_NODE_HAS_PROP(n, scroll_horizontal_layers),                           \
-              (static int32_t scroll_horizontal_layers##n[] =                               \
-                   DT_INST_PROP(n, scroll_horizontal_layers);),                             \
-              (/* Do nothing */))                                                           \
-  COND_CODE_1(DT_INST_NODE_HAS_PROP(n, scroll_snipe_layers),                                \
-              (static int32_t scroll_snipe_layers##n[] =                                    \
-                   DT_INST_PROP(n, scroll_snipe_layers);),                                  \
-              (/* Do nothing */))                                                           \
-  COND_CODE_1(DT_INST_NODE_HAS_PROP(n, scroll_horizontal_snipe_layers),                     \
-              (static int32_t scroll_horizontal_snipe_layers##n[] =                         \
-                   DT_INST_PROP(n, scroll_horizontal_snipe_layers);),                       \
-              (/* Do nothing */))                                                           \
   static const struct paw32xx_config paw32xx_cfg_##n = {                                    \
       .spi = SPI_DT_SPEC_INST_GET(n, PAW32XX_SPI_MODE, 0),                                  \
       .irq_gpio = GPIO_DT_SPEC_INST_GET(n, irq_gpios),                                      \
       .power_gpio = GPIO_DT_SPEC_INST_GET_OR(n, power_gpios, {0}),                          \
-      .scroll_layers = COND_CODE_1(DT_INST_NODE_HAS_PROP(n, scroll_layers),                 \
-                                   (scroll_layers##n), (NULL)),                             \
-      .scroll_layers_len =                                                                  \
-          COND_CODE_1(DT_INST_NODE_HAS_PROP(n, scroll_layers),                              \
-                      (DT_INST_PROP_LEN(n, scroll_layers)), (0)),                           \
-      .snipe_layers = COND_CODE_1(DT_INST_NODE_HAS_PROP(n, snipe_layers),                   \
-                                  (snipe_layers##n), (NULL)),                               \
-      .snipe_layers_len =                                                                   \
-          COND_CODE_1(DT_INST_NODE_HAS_PROP(n, snipe_layers),                               \
-                      (DT_INST_PROP_LEN(n, snipe_layers)), (0)),                            \
-      .scroll_horizontal_layers =                                                           \
-          COND_CODE_1(DT_INST_NODE_HAS_PROP(n, scroll_horizontal_layers),                   \
-                      (scroll_horizontal_layers##n), (NULL)),                               \
-      .scroll_horizontal_layers_len =                                                       \
-          COND_CODE_1(DT_INST_NODE_HAS_PROP(n, scroll_horizontal_layers),                   \
-                      (DT_INST_PROP_LEN(n, scroll_horizontal_layers)), (0)),                \
-      .scroll_snipe_layers =                                                                \
-          COND_CODE_1(DT_INST_NODE_HAS_PROP(n, scroll_snipe_layers),                        \
-                      (scroll_snipe_layers##n), (NULL)),                                    \
-      .scroll_snipe_layers_len =                                                            \
-          COND_CODE_1(DT_INST_NODE_HAS_PROP(n, scroll_snipe_layers),                        \
-                      (DT_INST_PROP_LEN(n, scroll_snipe_layers)), (0)),                     \
-      .scroll_horizontal_snipe_layers = COND_CODE_1(                                        \
-          DT_INST_NODE_HAS_PROP(n, scroll_horizontal_snipe_layers),                         \
-          (scroll_horizontal_snipe_layers##n), (NULL)),                                     \
-      .scroll_horizontal_snipe_layers_len = COND_CODE_1(                                    \
-          DT_INST_NODE_HAS_PROP(n, scroll_horizontal_snipe_layers),                         \
-          (DT_INST_PROP_LEN(n, scroll_horizontal_snipe_layers)), (0)),                      \
+      .layer_modes = {LISTIFY(PAW32XX_LAYER_MODES_LEN, PAW32XX_LAYER_MODE_PAIR, (,), n)},   \
       .res_cpi = DT_INST_PROP_OR(n, res_cpi, CONFIG_PAW3222_RES_CPI),                       \
       .snipe_cpi = DT_INST_PROP_OR(n, snipe_cpi, CONFIG_PAW3222_SNIPE_CPI),                 \
       .snipe_divisor =                                                                      \
@@ -215,11 +371,31 @@ static int paw32xx_init(const struct device *dev)
       .scroll_snipe_tick = DT_INST_PROP_OR(n, scroll_snipe_tick,                            \
                                            CONFIG_PAW3222_SCROLL_SNIPE_TICK),               \
       .force_awake = DT_INST_PROP(n, force_awake),                                          \
+      .power_profile = DT_INST_ENUM_IDX(n, power_profile),                                  \
       .rotation =                                                                           \
           DT_INST_PROP_OR(n, rotation, CONFIG_PAW3222_SENSOR_ROTATION),                     \
       .scroll_tick =                                                                        \
           DT_INST_PROP_OR(n, scroll_tick, CONFIG_PAW3222_SCROLL_TICK),                      \
+      .poll_min_us = DT_INST_PROP_OR(n, poll_min_us, CONFIG_PAW3222_POLL_MIN_US),           \
+      .poll_max_us = DT_INST_PROP_OR(n, poll_max_us, CONFIG_PAW3222_POLL_MAX_US),           \
+      .coalesce_us = DT_INST_PROP_OR(n, coalesce_us, CONFIG_PAW3222_COALESCE_US),           \
+      .autosuspend_ms = DT_INST_PROP_OR(n, autosuspend_ms, PAW32XX_AUTOSUSPEND_MS_DEFAULT), \
+      .awake_idle_ms = DT_INST_PROP_OR(n, awake_idle_ms, PAW32XX_AWAKE_IDLE_MS_DEFAULT),    \
+      .awake_layers = PAW32XX_LAYER_MASK(n, awake_layers),                                  \
+      .power_off_ms = DT_INST_PROP(n, power_off_ms),                                        \
+      .power_on_ms = DT_INST_PROP(n, power_on_ms),                                          \
+      .ready_timeout_ms = DT_INST_PROP(n, ready_timeout_ms),                                \
+      .accel = {                                                                            \
+          .type = DT_INST_ENUM_IDX(n, accel_curve),                                         \
+          .gain_max = DT_INST_PROP(n, accel_gain_max),                                      \
+          .speed_min = DT_INST_PROP(n, accel_speed_min),                                    \
+          .speed_max = DT_INST_PROP(n, accel_speed_max),                                    \
+          .exponent = DT_INST_PROP(n, accel_exponent),                                      \
+      },                                                                                    \
       .switch_method = DT_ENUM_IDX_OR(DT_DRV_INST(n), switch_method, PAW32XX_SWITCH_LAYER)};\
+  BUILD_ASSERT(!IS_ENABLED(CONFIG_PAW3222_PM_AUTOSUSPEND) ||                                \
+                   DT_INST_PROP(n, wakeup_source),                                          \
+               "CONFIG_PAW3222_PM_AUTOSUSPEND needs wakeup-source on every PAW3222 node");  \
   static struct paw32xx_data paw32xx_data_##n;                                              \
   PM_DEVICE_DT_INST_DEFINE(n, paw32xx_pm_action);                                           \
   DEVICE_DT_INST_DEFINE(n, paw32xx_init, PM_DEVICE_DT_INST_GET(n),                          \
@@ -228,4 +404,47 @@ static int paw32xx_init(const struct device *dev)
 
 DT_INST_FOREACH_STATUS_OKAY(PAW32XX_INIT)
 
+#define PAW32XX_DEVICE_ENTRY(n) DEVICE_DT_INST_GET(n),
+
+static const struct device *const paw32xx_devices[] = {
+    DT_INST_FOREACH_STATUS_OKAY(PAW32XX_DEVICE_ENTRY)};
+
+const struct device *paw32xx_get_device(size_t index)
+{
+  if (index >= ARRAY_SIZE(paw32xx_devices))
+  {
+    return NULL;
+  }
+
+  return paw32xx_devices[index];
+}
+
+/**
+ * @brief Refresh the cached input mode of every sensor on layer changes
+ *
+ * Layer changes are rare compared to motion samples, so the input mode is
+ * resolved here once per change instead of on every sample.
+ *
+ * @param eh Layer state changed event (unused)
+ *
+ * @return ZMK_EV_EVENT_BUBBLE to let other listeners see the event
+ */
+static int paw32xx_layer_state_listener(const zmk_event_t *eh)
+{
+  ARG_UNUSED(eh);
+
+  for (size_t i = 0; i < ARRAY_SIZE(paw32xx_devices); i++)
+  {
+    if (device_is_ready(paw32xx_devices[i]))
+    {
+      paw32xx_update_input_mode(paw32xx_devices[i]);
+    }
+  }
+
+  return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(paw32xx, paw32xx_layer_state_listener);
+ZMK_SUBSCRIPTION(paw32xx, zmk_layer_state_changed);
+
 #endif // DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
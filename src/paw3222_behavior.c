@@ -21,34 +21,17 @@ LOG_MODULE_REGISTER(paw32xx_behavior, CONFIG_ZMK_LOG_LEVEL);
 
 #define DT_DRV_COMPAT paw32xx_mode
 
-// Global pointer to the PAW3222 device (set during init)
-// Note: Currently supports only one device instance
-static const struct device *paw3222_dev = NULL;
-
 /**
- * @brief Set the global PAW3222 device reference for behavior system
- *
- * Stores a global reference to the PAW3222 device instance for use by the
- * behavior driver system. This allows behavior key bindings to control the
- * sensor's input mode without requiring direct device access.
+ * @brief Resolve the sensor a paw_mode behavior instance controls
  *
- * @param dev PAW3222 device pointer to store globally
- * 
- * @note This function is called automatically during device initialization
- *       when CONFIG_PAW3222_BEHAVIOR is enabled.
- * 
- * @warning Only supports a single PAW3222 device instance when using behaviors.
- *          Multiple devices would overwrite the global reference.
- *          For split keyboards with multiple PAW3222 devices, use layer-based
- *          switching instead of behavior-based switching.
+ * Uses the optional `sensor` phandle on the behavior node and falls back to
+ * the first enabled PAW3222 instance. Resolved at build time, so each
+ * behavior instance carries a constant device pointer.
  */
-void paw32xx_set_device_reference(const struct device *dev)
-{
-    if (paw3222_dev != NULL) {
-        LOG_WRN("PAW3222 device reference already set, overwriting. Multiple devices not fully supported.");
-    }
-    paw3222_dev = dev;
-}
+#define PAW32XX_MODE_SENSOR(n)                                              \
+  COND_CODE_1(DT_INST_NODE_HAS_PROP(n, sensor),                             \
+              (DEVICE_DT_GET(DT_INST_PHANDLE(n, sensor))),                  \
+              (DEVICE_DT_GET_ANY(pixart_paw3222)))
 
 /**
  * @brief Change the PAW3222 input mode and log the change
@@ -57,6 +40,7 @@ void paw32xx_set_device_reference(const struct device *dev)
  * for debugging purposes. This is a helper function used by the various
  * toggle mode functions.
  *
+ * @param dev PAW3222 device to update
  * @param new_mode The new input mode to set
  * 
  * @return 0 on success, negative error code on failure
@@ -66,15 +50,18 @@ void paw32xx_set_device_reference(const struct device *dev)
  * @note This function updates the mode immediately and the change takes
  *       effect on the next motion event.
  */
-static int paw32xx_change_mode(enum paw32xx_current_mode new_mode)
+static int paw32xx_change_mode(const struct device *dev, enum paw32xx_current_mode new_mode)
 {
-    if (!paw3222_dev) {
+    // Same check as the layer listener: a failed init leaves the work items
+    // that paw32xx_update_input_mode() submits uninitialized
+    if (dev == NULL || !device_is_ready(dev)) {
         LOG_ERR("PAW3222 device not initialized");
         return -ENODEV;
     }
 
-    struct paw32xx_data *data = paw3222_dev->data;
+    struct paw32xx_data *data = dev->data;
     data->current_mode = new_mode;
+    paw32xx_update_input_mode(dev);
 
     const char* mode_names[] = {
         "MOVE", "SCROLL", "SCROLL_HORIZONTAL",
@@ -82,7 +69,7 @@ static int paw32xx_change_mode(enum paw32xx_current_mode new_mode)
     };
 
     if ((int)new_mode >= 0 && new_mode < ARRAY_SIZE(mode_names)) {
-        LOG_INF("Switched to %s mode", mode_names[new_mode]);
+        LOG_INF("%s switched to %s mode", dev->name, mode_names[new_mode]);
     }
 
     return 0;
@@ -98,30 +85,32 @@ static int paw32xx_change_mode(enum paw32xx_current_mode new_mode)
  * - From MOVE or SNIPE: Switch to SCROLL
  * - From any SCROLL mode: Switch to MOVE
  *
+ * @param dev PAW3222 device to update
+ *
  * @return 0 on success, negative error code on failure
  * @retval 0 Mode toggled successfully
  * @retval -ENODEV PAW3222 device not initialized
  * 
  * @note This implements parameter 0 of the paw_mode behavior
  */
-static int paw32xx_move_scroll_toggle_mode(void)
+static int paw32xx_move_scroll_toggle_mode(const struct device *dev)
 {
-    if (!paw3222_dev) {
+    if (dev == NULL) {
         LOG_ERR("PAW3222 device not initialized");
         return -ENODEV;
     }
 
-    struct paw32xx_data *data = paw3222_dev->data;
+    struct paw32xx_data *data = dev->data;
 
     switch (data->current_mode) {
         case PAW32XX_MODE_MOVE:
         case PAW32XX_MODE_SNIPE:
-            return paw32xx_change_mode(PAW32XX_MODE_SCROLL);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SCROLL);
         case PAW32XX_MODE_SCROLL:
         case PAW32XX_MODE_SCROLL_HORIZONTAL:
         case PAW32XX_MODE_SCROLL_SNIPE:
         case PAW32XX_MODE_SCROLL_HORIZONTAL_SNIPE:
-            return paw32xx_change_mode(PAW32XX_MODE_MOVE);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_MOVE);
         default:
             LOG_ERR("Unsupported mode");
             return -ENODEV;
@@ -139,34 +128,36 @@ static int paw32xx_move_scroll_toggle_mode(void)
  * - SCROLL ↔ SCROLL_SNIPE (vertical scrolling)
  * - SCROLL_HORIZONTAL ↔ SCROLL_HORIZONTAL_SNIPE (horizontal scrolling)
  *
+ * @param dev PAW3222 device to update
+ *
  * @return 0 on success, negative error code on failure
  * @retval 0 Mode toggled successfully
  * @retval -ENODEV PAW3222 device not initialized or unsupported mode
  * 
  * @note This implements parameter 1 of the paw_mode behavior
  */
-static int paw32xx_normal_snipe_toggle_mode(void)
+static int paw32xx_normal_snipe_toggle_mode(const struct device *dev)
 {
-    if (!paw3222_dev) {
+    if (dev == NULL) {
         LOG_ERR("PAW3222 device not initialized");
         return -ENODEV;
     }
 
-    struct paw32xx_data *data = paw3222_dev->data;
+    struct paw32xx_data *data = dev->data;
 
     switch (data->current_mode) {
         case PAW32XX_MODE_MOVE:
-            return paw32xx_change_mode(PAW32XX_MODE_SNIPE);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SNIPE);
         case PAW32XX_MODE_SNIPE:
-            return paw32xx_change_mode(PAW32XX_MODE_MOVE);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_MOVE);
         case PAW32XX_MODE_SCROLL:
-            return paw32xx_change_mode(PAW32XX_MODE_SCROLL_SNIPE);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SCROLL_SNIPE);
         case PAW32XX_MODE_SCROLL_SNIPE:
-            return paw32xx_change_mode(PAW32XX_MODE_SCROLL);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SCROLL);
         case PAW32XX_MODE_SCROLL_HORIZONTAL:
-            return paw32xx_change_mode(PAW32XX_MODE_SCROLL_HORIZONTAL_SNIPE);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SCROLL_HORIZONTAL_SNIPE);
         case PAW32XX_MODE_SCROLL_HORIZONTAL_SNIPE:
-            return paw32xx_change_mode(PAW32XX_MODE_SCROLL_HORIZONTAL);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SCROLL_HORIZONTAL);
         default:
             LOG_ERR("Unsupported mode");
             return -ENODEV;
@@ -185,20 +176,22 @@ static int paw32xx_normal_snipe_toggle_mode(void)
  * - SCROLL_SNIPE ↔ SCROLL_HORIZONTAL_SNIPE
  * - MOVE/SNIPE: No effect (logs info message)
  *
+ * @param dev PAW3222 device to update
+ *
  * @return 0 on success, negative error code on failure
  * @retval 0 Mode toggled successfully
  * @retval -ENODEV PAW3222 device not initialized, not in scroll mode, or unsupported mode
  * 
  * @note This implements parameter 2 of the paw_mode behavior
  */
-static int paw32xx_vertical_horizontal_toggle_mode(void)
+static int paw32xx_vertical_horizontal_toggle_mode(const struct device *dev)
 {
-    if (!paw3222_dev) {
+    if (dev == NULL) {
         LOG_ERR("PAW3222 device not initialized");
         return -ENODEV;
     }
 
-    struct paw32xx_data *data = paw3222_dev->data;
+    struct paw32xx_data *data = dev->data;
 
     if (data->current_mode == PAW32XX_MODE_MOVE || data->current_mode == PAW32XX_MODE_SNIPE) {
         LOG_INF("PAW3222 not SCROLL MODE");
@@ -207,13 +200,13 @@ static int paw32xx_vertical_horizontal_toggle_mode(void)
 
     switch (data->current_mode) {
         case PAW32XX_MODE_SCROLL:
-            return paw32xx_change_mode(PAW32XX_MODE_SCROLL_HORIZONTAL);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SCROLL_HORIZONTAL);
         case PAW32XX_MODE_SCROLL_SNIPE:
-            return paw32xx_change_mode(PAW32XX_MODE_SCROLL_HORIZONTAL_SNIPE);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SCROLL_HORIZONTAL_SNIPE);
         case PAW32XX_MODE_SCROLL_HORIZONTAL:
-            return paw32xx_change_mode(PAW32XX_MODE_SCROLL);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SCROLL);
         case PAW32XX_MODE_SCROLL_HORIZONTAL_SNIPE:
-            return paw32xx_change_mode(PAW32XX_MODE_SCROLL_SNIPE);
+            return paw32xx_change_mode(dev, PAW32XX_MODE_SCROLL_SNIPE);
         default:
             LOG_ERR("Unsupported mode");
             return -ENODEV;
@@ -231,17 +224,16 @@ static int paw32xx_vertical_horizontal_toggle_mode(void)
  * - 1: Normal/Snipe toggle  
  * - 2: Vertical/Horizontal toggle
  *
+ * @param dev PAW3222 device controlled by the behavior instance
  * @param binding Pointer to the behavior binding containing parameters
- * @param binding_event Event information (unused)
  * 
  * @return 0 on success, negative error code on failure
  * @retval 0 Mode change completed successfully
  * @retval -EINVAL Unknown parameter value
  * @retval -ENODEV PAW3222 device not available or mode change failed
  */
-static int on_paw32xx_mode_binding_pressed(
-    struct zmk_behavior_binding *binding,
-    struct zmk_behavior_binding_event binding_event)
+static int paw32xx_mode_binding_pressed(const struct device *dev,
+                                        struct zmk_behavior_binding *binding)
 {
     uint32_t param1 = binding->param1;
 
@@ -250,13 +242,13 @@ static int on_paw32xx_mode_binding_pressed(
     switch (param1) {
         case 0: // Move <-> Scroll Toggle mode
             LOG_DBG("Move <-> Scroll Toggle mode");
-            return paw32xx_move_scroll_toggle_mode();
+            return paw32xx_move_scroll_toggle_mode(dev);
         case 1: // Normal <-> Snipe Toggle mode
             LOG_DBG("Normal <-> Snipe Toggle mode");
-            return paw32xx_normal_snipe_toggle_mode();
+            return paw32xx_normal_snipe_toggle_mode(dev);
         case 2: // Vertical <-> Horizontal mode
             LOG_DBG("Vertical <-> Horizontal mode");
-            return paw32xx_vertical_horizontal_toggle_mode();
+            return paw32xx_vertical_horizontal_toggle_mode(dev);
         default:
             LOG_ERR("Unknown PAW3222 mode parameter: %d", param1);
             return -EINVAL;
@@ -295,18 +287,6 @@ static int on_paw32xx_mode_binding_released(
 
 #if DT_HAS_COMPAT_STATUS_OKAY(DT_DRV_COMPAT)
 
-static const struct behavior_driver_api behavior_paw32xx_mode_driver_api = {
-    .locality = BEHAVIOR_LOCALITY_CENTRAL,
-    .binding_pressed = on_paw32xx_mode_binding_pressed,
-    .binding_released = on_paw32xx_mode_binding_released,
-    .sensor_binding_accept_data = NULL,
-    .sensor_binding_process = NULL,
-#if IS_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA)
-    .get_parameter_metadata = NULL,
-    .parameter_metadata = NULL,
-#endif
-};
-
 /**
  * @brief Initialize the PAW3222 mode behavior driver
  *
@@ -317,8 +297,8 @@ static const struct behavior_driver_api behavior_paw32xx_mode_driver_api = {
  * 
  * @return Always returns 0 (initialization always succeeds)
  * 
- * @note The actual PAW3222 device reference is set separately during
- *       PAW3222 device initialization via paw32xx_set_device_reference().
+ * @note The controlled PAW3222 device is fixed per behavior instance at
+ *       build time, see PAW32XX_MODE_SENSOR().
  */
 static int behavior_paw32xx_mode_init(const struct device *dev)
 {
@@ -326,10 +306,30 @@ static int behavior_paw32xx_mode_init(const struct device *dev)
     return 0;
 }
 
+// Each instance gets its own pressed callback bound to a constant sensor
+// pointer, so dispatch needs no lookup of the behavior device
 #define PAW32XX_MODE_INST(n)                                                \
+  static int on_paw32xx_mode_binding_pressed_##n(                           \
+      struct zmk_behavior_binding *binding,                                 \
+      struct zmk_behavior_binding_event binding_event)                      \
+  {                                                                         \
+    return paw32xx_mode_binding_pressed(PAW32XX_MODE_SENSOR(n), binding);   \
+  }                                                                         \
+                                                                            \
+  static const struct behavior_driver_api behavior_paw32xx_mode_api_##n = { \
+      .locality = BEHAVIOR_LOCALITY_CENTRAL,                                \
+      .binding_pressed = on_paw32xx_mode_binding_pressed_##n,               \
+      .binding_released = on_paw32xx_mode_binding_released,                 \
+      .sensor_binding_accept_data = NULL,                                   \
+      .sensor_binding_process = NULL,                                       \
+      IF_ENABLED(CONFIG_ZMK_BEHAVIOR_METADATA,                              \
+                 (.get_parameter_metadata = NULL,                           \
+                  .parameter_metadata = NULL,))                             \
+  };                                                                        \
+                                                                            \
   BEHAVIOR_DT_INST_DEFINE(n, behavior_paw32xx_mode_init, NULL, NULL, NULL,  \
                           POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, \
-                          &behavior_paw32xx_mode_driver_api);
+                          &behavior_paw32xx_mode_api_##n);
 
 DT_INST_FOREACH_STATUS_OKAY(PAW32XX_MODE_INST)
 
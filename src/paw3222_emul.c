@@ -0,0 +1,366 @@
+/*
+ * Copyright 2025 nuovotaka
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/drivers/spi.h>
+#include <zephyr/drivers/spi_emul.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include "paw3222_emul.h"
+#include "paw3222_regs.h"
+
+LOG_MODULE_REGISTER(paw32xx_emul, CONFIG_ZMK_LOG_LEVEL);
+
+#define DT_DRV_COMPAT pixart_paw3222
+
+/* Register addresses are 7 bits wide, bit 7 selects a write cycle */
+#define PAW32XX_EMUL_NUM_REGS 0x80
+#define PAW32XX_EMUL_ADDR_MASK 0x7f
+
+/* Reset values used by the emulator for registers the driver touches */
+#define PAW32XX_EMUL_RESET_OPERATION_MODE OPERATION_MODE_SLP_MASK
+#define PAW32XX_EMUL_RESET_CPI (1000 / RES_STEP)
+
+struct paw32xx_emul_sample {
+    int8_t dx;
+    int8_t dy;
+};
+
+struct paw32xx_emul_cfg {
+    struct gpio_dt_spec irq_gpio;
+};
+
+struct paw32xx_emul_data {
+    struct k_spinlock lock;
+    uint8_t regs[PAW32XX_EMUL_NUM_REGS];
+
+    /* Scripted motion FIFO */
+    struct paw32xx_emul_sample fifo[CONFIG_PAW3222_EMUL_FIFO_SIZE];
+    uint16_t fifo_head;
+    uint16_t fifo_count;
+    bool latched;
+
+    struct paw32xx_emul_stats stats;
+};
+
+static void paw32xx_emul_reset_regs(struct paw32xx_emul_data *data) {
+    memset(data->regs, 0, sizeof(data->regs));
+    data->regs[PAW32XX_PRODUCT_ID1] = PRODUCT_ID_PAW32XX;
+    data->regs[PAW32XX_OPERATION_MODE] = PAW32XX_EMUL_RESET_OPERATION_MODE;
+    data->regs[PAW32XX_WRITE_PROTECT] = WRITE_PROTECT_ENABLE;
+    data->regs[PAW32XX_CPI_X] = PAW32XX_EMUL_RESET_CPI;
+    data->regs[PAW32XX_CPI_Y] = PAW32XX_EMUL_RESET_CPI;
+    data->latched = false;
+}
+
+static bool paw32xx_emul_is_protected(uint8_t addr) {
+    switch (addr) {
+    case PAW32XX_OPERATION_MODE:
+    case PAW32XX_SLEEP1:
+    case PAW32XX_SLEEP2:
+    case PAW32XX_SLEEP3:
+    case PAW32XX_CPI_X:
+    case PAW32XX_CPI_Y:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* Latch the head of the motion FIFO into the delta registers */
+static void paw32xx_emul_latch(struct paw32xx_emul_data *data) {
+    if (data->latched) {
+        return;
+    }
+
+    if (data->fifo_count == 0) {
+        data->regs[PAW32XX_MOTION] = 0;
+        data->regs[PAW32XX_DELTA_X] = 0;
+        data->regs[PAW32XX_DELTA_Y] = 0;
+        return;
+    }
+
+    const struct paw32xx_emul_sample *sample = &data->fifo[data->fifo_head];
+
+    data->regs[PAW32XX_MOTION] = MOTION_STATUS_MOTION;
+    data->regs[PAW32XX_DELTA_X] = (uint8_t)sample->dx;
+    data->regs[PAW32XX_DELTA_Y] = (uint8_t)sample->dy;
+    data->latched = true;
+}
+
+/* Reading DELTA_Y completes the sample, like the real sensor clearing its deltas */
+static void paw32xx_emul_consume(struct paw32xx_emul_data *data) {
+    if (!data->latched) {
+        return;
+    }
+
+    data->fifo_head = (data->fifo_head + 1) % CONFIG_PAW3222_EMUL_FIFO_SIZE;
+    data->fifo_count--;
+    data->latched = false;
+    data->regs[PAW32XX_MOTION] = 0;
+}
+
+static uint8_t paw32xx_emul_read(struct paw32xx_emul_data *data, uint8_t addr) {
+    uint8_t value;
+
+    data->stats.reg_reads++;
+
+    switch (addr) {
+    case PAW32XX_MOTION:
+    case PAW32XX_DELTA_X:
+        paw32xx_emul_latch(data);
+        value = data->regs[addr];
+        break;
+    case PAW32XX_DELTA_Y:
+        paw32xx_emul_latch(data);
+        value = data->regs[addr];
+        paw32xx_emul_consume(data);
+        break;
+    default:
+        value = data->regs[addr];
+        break;
+    }
+
+    return value;
+}
+
+static void paw32xx_emul_write(struct paw32xx_emul_data *data, uint8_t addr, uint8_t value) {
+    if (paw32xx_emul_is_protected(addr) &&
+        data->regs[PAW32XX_WRITE_PROTECT] != WRITE_PROTECT_DISABLE) {
+        LOG_WRN("Write to 0x%02x dropped, write protection enabled", addr);
+        data->stats.wp_violations++;
+        return;
+    }
+
+    data->stats.reg_writes++;
+
+    switch (addr) {
+    case PAW32XX_PRODUCT_ID1:
+    case PAW32XX_PRODUCT_ID2:
+    case PAW32XX_MOTION:
+    case PAW32XX_DELTA_X:
+    case PAW32XX_DELTA_Y:
+        /* Read-only registers */
+        break;
+    case PAW32XX_CONFIGURATION:
+        if (value & CONFIGURATION_RESET) {
+            data->stats.resets++;
+            paw32xx_emul_reset_regs(data);
+            /* The reset bit is self-clearing */
+            data->regs[addr] = value & ~CONFIGURATION_RESET;
+        } else {
+            data->regs[addr] = value;
+        }
+        break;
+    default:
+        data->regs[addr] = value;
+        break;
+    }
+}
+
+static size_t paw32xx_emul_buf_set_len(const struct spi_buf_set *set) {
+    size_t len = 0;
+
+    if (set == NULL) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < set->count; i++) {
+        len += set->buffers[i].len;
+    }
+
+    return len;
+}
+
+static uint8_t *paw32xx_emul_buf_set_at(const struct spi_buf_set *set, size_t pos) {
+    if (set == NULL) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < set->count; i++) {
+        if (pos < set->buffers[i].len) {
+            return set->buffers[i].buf ? (uint8_t *)set->buffers[i].buf + pos : NULL;
+        }
+        pos -= set->buffers[i].len;
+    }
+
+    return NULL;
+}
+
+static void paw32xx_emul_update_irq(const struct emul *target) {
+    const struct paw32xx_emul_cfg *cfg = target->cfg;
+    struct paw32xx_emul_data *data = target->data;
+    k_spinlock_key_t key;
+    bool asserted;
+    int level;
+
+    if (cfg->irq_gpio.port == NULL) {
+        return;
+    }
+
+    key = k_spin_lock(&data->lock);
+    asserted = data->fifo_count > 0;
+    k_spin_unlock(&data->lock, key);
+
+    /* The motion pin is active low on the real sensor */
+    level = (cfg->irq_gpio.dt_flags & GPIO_ACTIVE_LOW) ? !asserted : asserted;
+
+    /* Fails harmlessly until the driver has configured the pin as input */
+    (void)gpio_emul_input_set(cfg->irq_gpio.port, cfg->irq_gpio.pin, level);
+}
+
+static int paw32xx_emul_io(const struct emul *target, const struct spi_config *config,
+                           const struct spi_buf_set *tx_bufs,
+                           const struct spi_buf_set *rx_bufs) {
+    struct paw32xx_emul_data *data = target->data;
+    size_t len = MAX(paw32xx_emul_buf_set_len(tx_bufs), paw32xx_emul_buf_set_len(rx_bufs));
+    bool expect_addr = true;
+    uint8_t addr = 0;
+    k_spinlock_key_t key;
+
+    ARG_UNUSED(config);
+
+    key = k_spin_lock(&data->lock);
+    data->stats.transfers++;
+
+    /* Each cycle is an address byte followed by one data byte */
+    for (size_t pos = 0; pos < len; pos++) {
+        const uint8_t *tx = paw32xx_emul_buf_set_at(tx_bufs, pos);
+        uint8_t *rx = paw32xx_emul_buf_set_at(rx_bufs, pos);
+        uint8_t out = 0;
+
+        if (expect_addr) {
+            addr = tx ? *tx : 0;
+        } else if (addr & SPI_WRITE) {
+            paw32xx_emul_write(data, addr & PAW32XX_EMUL_ADDR_MASK, tx ? *tx : 0);
+        } else {
+            out = paw32xx_emul_read(data, addr & PAW32XX_EMUL_ADDR_MASK);
+        }
+
+        if (rx != NULL) {
+            *rx = out;
+        }
+        expect_addr = !expect_addr;
+    }
+    k_spin_unlock(&data->lock, key);
+
+    paw32xx_emul_update_irq(target);
+
+    return 0;
+}
+
+int paw32xx_emul_push_motion(const struct emul *target, int8_t dx, int8_t dy) {
+    struct paw32xx_emul_data *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    size_t tail;
+
+    if (data->fifo_count >= CONFIG_PAW3222_EMUL_FIFO_SIZE) {
+        k_spin_unlock(&data->lock, key);
+        return -ENOMEM;
+    }
+
+    tail = (data->fifo_head + data->fifo_count) % CONFIG_PAW3222_EMUL_FIFO_SIZE;
+    data->fifo[tail].dx = dx;
+    data->fifo[tail].dy = dy;
+    data->fifo_count++;
+    k_spin_unlock(&data->lock, key);
+
+    paw32xx_emul_update_irq(target);
+
+    return 0;
+}
+
+void paw32xx_emul_flush_motion(const struct emul *target) {
+    struct paw32xx_emul_data *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    data->fifo_head = 0;
+    data->fifo_count = 0;
+    data->latched = false;
+    data->regs[PAW32XX_MOTION] = 0;
+    k_spin_unlock(&data->lock, key);
+
+    paw32xx_emul_update_irq(target);
+}
+
+uint32_t paw32xx_emul_pending_motion(const struct emul *target) {
+    struct paw32xx_emul_data *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    uint32_t count = data->fifo_count;
+
+    k_spin_unlock(&data->lock, key);
+
+    return count;
+}
+
+uint8_t paw32xx_emul_get_reg(const struct emul *target, uint8_t addr) {
+    struct paw32xx_emul_data *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    uint8_t value = data->regs[addr & PAW32XX_EMUL_ADDR_MASK];
+
+    k_spin_unlock(&data->lock, key);
+
+    return value;
+}
+
+void paw32xx_emul_set_reg(const struct emul *target, uint8_t addr, uint8_t value) {
+    struct paw32xx_emul_data *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    data->regs[addr & PAW32XX_EMUL_ADDR_MASK] = value;
+    k_spin_unlock(&data->lock, key);
+}
+
+void paw32xx_emul_get_stats(const struct emul *target, struct paw32xx_emul_stats *stats) {
+    struct paw32xx_emul_data *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    *stats = data->stats;
+    k_spin_unlock(&data->lock, key);
+}
+
+void paw32xx_emul_reset_stats(const struct emul *target) {
+    struct paw32xx_emul_data *data = target->data;
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    memset(&data->stats, 0, sizeof(data->stats));
+    k_spin_unlock(&data->lock, key);
+}
+
+static int paw32xx_emul_init(const struct emul *target, const struct device *parent) {
+    struct paw32xx_emul_data *data = target->data;
+
+    ARG_UNUSED(parent);
+
+    paw32xx_emul_reset_regs(data);
+    data->fifo_head = 0;
+    data->fifo_count = 0;
+    memset(&data->stats, 0, sizeof(data->stats));
+
+    return 0;
+}
+
+static const struct spi_emul_api paw32xx_emul_spi_api = {
+    .io = paw32xx_emul_io,
+};
+
+#define PAW32XX_EMUL(n)                                                        \
+    static const struct paw32xx_emul_cfg paw32xx_emul_cfg_##n = {              \
+        .irq_gpio = GPIO_DT_SPEC_INST_GET_OR(n, irq_gpios, {0}),               \
+    };                                                                         \
+    static struct paw32xx_emul_data paw32xx_emul_data_##n;                     \
+    EMUL_DT_INST_DEFINE(n, paw32xx_emul_init, &paw32xx_emul_data_##n,          \
+                        &paw32xx_emul_cfg_##n, &paw32xx_emul_spi_api, NULL)
+
+DT_INST_FOREACH_STATUS_OKAY(PAW32XX_EMUL)
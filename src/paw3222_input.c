@@ -8,14 +8,29 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/input/input.h>
+#include <zephyr/init.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/pm/device_runtime.h>
 #include <zephyr/sys/util.h>
 #include <zmk/keymap.h>
 
+#ifdef CONFIG_PAW3222_COALESCE_BLE_INTERVAL
+#include <zephyr/bluetooth/conn.h>
+
+// HID reports go to the host of the active ZMK profile. Split peripherals
+// only report over their link to the central.
+#if defined(CONFIG_ZMK_BLE) &&                                                 \
+    (!defined(CONFIG_ZMK_SPLIT) || defined(CONFIG_ZMK_SPLIT_ROLE_CENTRAL))
+#define PAW32XX_BLE_ACTIVE_PROFILE
+#include <zmk/ble.h>
+#endif
+#endif
+
 // Utility macros
 #ifndef CLAMP
 #define CLAMP(val, low, high)                                                  \
@@ -34,6 +49,189 @@
 
 LOG_MODULE_DECLARE(paw32xx);
 
+#ifdef CONFIG_PAW3222_MOTION_WORKQUEUE
+K_THREAD_STACK_DEFINE(paw32xx_motion_wq_stack,
+                      CONFIG_PAW3222_MOTION_WORKQUEUE_STACK_SIZE);
+static struct k_work_q paw32xx_motion_wq;
+
+static int paw32xx_motion_wq_init(void) {
+  const struct k_work_queue_config wq_cfg = {
+      .name = "paw32xx_motion",
+  };
+
+  k_work_queue_start(&paw32xx_motion_wq, paw32xx_motion_wq_stack,
+                     K_THREAD_STACK_SIZEOF(paw32xx_motion_wq_stack),
+                     CONFIG_PAW3222_MOTION_WORKQUEUE_PRIORITY, &wq_cfg);
+  return 0;
+}
+
+// Start the queue before any sensor instance can submit motion work
+SYS_INIT(paw32xx_motion_wq_init, POST_KERNEL, CONFIG_KERNEL_INIT_PRIORITY_DEFAULT);
+#endif
+
+/**
+ * @brief Submit driver work to the motion workqueue
+ *
+ * Uses the dedicated motion workqueue when CONFIG_PAW3222_MOTION_WORKQUEUE
+ * is enabled, otherwise the system workqueue. Keeping all driver work on one
+ * queue serializes its SPI transactions.
+ *
+ * @param work Work item to submit
+ *
+ * @return Result of k_work_submit_to_queue()
+ */
+static int paw32xx_submit_work(struct k_work *work) {
+#ifdef CONFIG_PAW3222_MOTION_WORKQUEUE
+  return k_work_submit_to_queue(&paw32xx_motion_wq, work);
+#else
+  return k_work_submit(work);
+#endif
+}
+
+// Delayed counterpart of paw32xx_submit_work()
+int paw32xx_schedule_work(struct k_work_delayable *dwork, k_timeout_t delay) {
+#ifdef CONFIG_PAW3222_MOTION_WORKQUEUE
+  return k_work_schedule_for_queue(&paw32xx_motion_wq, dwork, delay);
+#else
+  return k_work_schedule(dwork, delay);
+#endif
+}
+
+#ifdef CONFIG_PAW3222_COALESCE_BLE_INTERVAL
+// LE connection intervals are in units of 1.25 ms
+#define PAW32XX_BLE_INTERVAL_TO_US(interval) ((uint32_t)(interval) * 1250U)
+
+// Interval of each LE connection, so one link's events never change or clear
+// the window used for another
+struct paw32xx_ble_link {
+  struct bt_conn *conn; // NULL when the slot is free
+  uint32_t interval_us;
+};
+
+static struct paw32xx_ble_link paw32xx_ble_links[CONFIG_BT_MAX_CONN];
+static struct bt_conn *paw32xx_ble_last_conn; // Most recently connected or updated
+static struct k_spinlock paw32xx_ble_lock;
+
+static void paw32xx_ble_set_interval(struct bt_conn *conn, uint32_t interval_us) {
+  struct paw32xx_ble_link *slot = NULL;
+  k_spinlock_key_t key = k_spin_lock(&paw32xx_ble_lock);
+
+  for (size_t i = 0; i < ARRAY_SIZE(paw32xx_ble_links); i++) {
+    if (paw32xx_ble_links[i].conn == conn) {
+      slot = &paw32xx_ble_links[i];
+      break;
+    }
+    if (paw32xx_ble_links[i].conn == NULL && slot == NULL) {
+      slot = &paw32xx_ble_links[i];
+    }
+  }
+
+  if (slot != NULL) {
+    slot->conn = conn;
+    slot->interval_us = interval_us;
+    paw32xx_ble_last_conn = conn;
+  }
+  k_spin_unlock(&paw32xx_ble_lock, key);
+}
+
+// Interval of the connection carrying HID reports, 0 if it is not up
+static uint32_t paw32xx_ble_interval_us(void) {
+  uint32_t interval_us = 0;
+#ifdef PAW32XX_BLE_ACTIVE_PROFILE
+  const bt_addr_le_t *addr = zmk_ble_active_profile_addr();
+#endif
+  k_spinlock_key_t key = k_spin_lock(&paw32xx_ble_lock);
+
+  for (size_t i = 0; i < ARRAY_SIZE(paw32xx_ble_links); i++) {
+    const struct paw32xx_ble_link *link = &paw32xx_ble_links[i];
+
+    if (link->conn == NULL) {
+      continue;
+    }
+#ifdef PAW32XX_BLE_ACTIVE_PROFILE
+    if (bt_addr_le_cmp(bt_conn_get_dst(link->conn), addr) == 0) {
+      interval_us = link->interval_us;
+      break;
+    }
+#else
+    // Without profiles: the most recently active link, or any that is up
+    if (link->conn == paw32xx_ble_last_conn || interval_us == 0) {
+      interval_us = link->interval_us;
+    }
+#endif
+  }
+  k_spin_unlock(&paw32xx_ble_lock, key);
+
+  return interval_us;
+}
+
+static void paw32xx_ble_connected(struct bt_conn *conn, uint8_t err) {
+  struct bt_conn_info info;
+
+  if (err == 0 && bt_conn_get_info(conn, &info) == 0 && info.type == BT_CONN_TYPE_LE) {
+    paw32xx_ble_set_interval(conn, PAW32XX_BLE_INTERVAL_TO_US(info.le.interval));
+  }
+}
+
+static void paw32xx_ble_disconnected(struct bt_conn *conn, uint8_t reason) {
+  k_spinlock_key_t key = k_spin_lock(&paw32xx_ble_lock);
+
+  ARG_UNUSED(reason);
+
+  for (size_t i = 0; i < ARRAY_SIZE(paw32xx_ble_links); i++) {
+    if (paw32xx_ble_links[i].conn == conn) {
+      paw32xx_ble_links[i].conn = NULL;
+    }
+  }
+  if (paw32xx_ble_last_conn == conn) {
+    paw32xx_ble_last_conn = NULL;
+  }
+  k_spin_unlock(&paw32xx_ble_lock, key);
+}
+
+static void paw32xx_ble_param_updated(struct bt_conn *conn, uint16_t interval,
+                                      uint16_t latency, uint16_t timeout) {
+  ARG_UNUSED(latency);
+  ARG_UNUSED(timeout);
+
+  paw32xx_ble_set_interval(conn, PAW32XX_BLE_INTERVAL_TO_US(interval));
+}
+
+BT_CONN_CB_DEFINE(paw32xx_conn_callbacks) = {
+    .connected = paw32xx_ble_connected,
+    .disconnected = paw32xx_ble_disconnected,
+    .le_param_updated = paw32xx_ble_param_updated,
+};
+#endif
+
+// Delta magnitude at which polling runs at the minimum interval. Deltas are
+// clipped at +/-127, so poll at full rate well before that point.
+#define PAW32XX_POLL_FAST_DELTA 96
+
+// Largest magnitude a delta register can report, anything at or above it
+// has been clipped
+#define PAW32XX_SATURATION_DELTA 127
+
+// Magnitude below which a saturation CPI reduction is undone; doubling the
+// CPI keeps such motion clear of PAW32XX_SATURATION_DELTA
+#define PAW32XX_SATURATION_RESTORE_DELTA 48
+
+// Timestamps taken along the motion path; stage i of enum
+// paw32xx_latency_stage ends at mark i + 1
+enum paw32xx_latency_mark {
+  PAW32XX_MARK_SUBMIT,
+  PAW32XX_MARK_WORK,
+  PAW32XX_MARK_SPI,
+  PAW32XX_MARK_MODE,
+  PAW32XX_MARK_REPORT,
+};
+
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+#define PAW32XX_LATENCY_MARK(data, mark) ((data)->latency_marks[(mark)] = k_cycle_get_32())
+#else
+#define PAW32XX_LATENCY_MARK(data, mark) do { } while (0)
+#endif
+
 /**
  * @brief Calculate absolute value of int16_t (memory optimized)
  *
@@ -52,6 +250,478 @@ static inline int16_t abs_int16(int16_t value) {
   return (value < 0) ? -value : value;
 }
 
+/**
+ * @brief Divide a motion delta, carrying the remainder to the next sample
+ *
+ * Precision modes scale motion down by an integer divisor. Plain integer
+ * division drops up to divisor-1 counts on every sample, so slow motion
+ * below the divisor never produces output. This keeps the remainder in a
+ * per-axis accumulator and adds it to the next delta, so every sensor count
+ * is eventually reported at the reduced rate.
+ *
+ * @param delta Raw delta of the current sample
+ * @param divisor Precision divisor (must not be 0)
+ * @param remainder Pointer to the per-axis remainder, updated in place
+ *
+ * @return Delta scaled by 1/divisor including the carried remainder
+ *
+ * @note C division truncates toward zero, so the remainder keeps the sign
+ *       of the motion and a direction change cancels it out.
+ */
+static inline int16_t divide_with_carry(int16_t delta, uint8_t divisor,
+                                        int16_t *remainder) {
+  int32_t total = (int32_t)*remainder + delta;
+  int32_t out = total / divisor;
+
+  *remainder = (int16_t)(total - out * divisor);
+  return (int16_t)out;
+}
+
+#ifdef CONFIG_PAW3222_ACCEL
+// Curve position u and curve values are Q16 fractions of the speed range
+#define PAW32XX_ACCEL_Q16 BIT(16)
+
+void paw32xx_accel_build_lut(const struct paw32xx_accel_curve *curve, uint16_t *lut) {
+  int32_t gain_max = (int32_t)curve->gain_max * PAW32XX_ACCEL_GAIN_ONE / 100;
+  uint32_t span = MAX(curve->speed_max, curve->speed_min + 1) - curve->speed_min;
+
+  for (uint32_t speed = 0; speed < PAW32XX_ACCEL_LUT_LEN; speed++) {
+    uint64_t u, f;
+
+    if (curve->type == PAW32XX_ACCEL_NONE || speed <= curve->speed_min) {
+      lut[speed] = PAW32XX_ACCEL_GAIN_ONE;
+      continue;
+    }
+
+    u = MIN(((speed - curve->speed_min) * PAW32XX_ACCEL_Q16) / span, PAW32XX_ACCEL_Q16);
+
+    switch (curve->type) {
+    case PAW32XX_ACCEL_POWER:
+      f = u;
+      for (uint8_t i = 1; i < CLAMP(curve->exponent, 1, 4); i++) {
+        f = (f * u) >> 16;
+      }
+      break;
+    case PAW32XX_ACCEL_SIGMOID:
+      f = (((u * u) >> 16) * (3 * PAW32XX_ACCEL_Q16 - 2 * u)) >> 16;
+      break;
+    default:
+      f = u;
+      break;
+    }
+
+    lut[speed] = CLAMP(PAW32XX_ACCEL_GAIN_ONE +
+                           (((int64_t)(gain_max - PAW32XX_ACCEL_GAIN_ONE) * (int64_t)f) >> 16),
+                       0, UINT16_MAX);
+  }
+}
+
+/**
+ * @brief Scale a motion delta by a Q8 gain, carrying the fraction
+ *
+ * @param delta Delta of the current sample
+ * @param gain Q8 gain from the acceleration table
+ * @param remainder Pointer to the per-axis Q8 fraction, updated in place
+ *
+ * @return Scaled delta including the carried fraction
+ */
+static inline int16_t scale_with_carry(int16_t delta, uint16_t gain, int16_t *remainder) {
+  int32_t total = (int32_t)delta * gain + *remainder;
+  int32_t out = total / PAW32XX_ACCEL_GAIN_ONE;
+
+  *remainder = (int16_t)(total - out * PAW32XX_ACCEL_GAIN_ONE);
+  return (int16_t)CLAMP(out, INT16_MIN, INT16_MAX);
+}
+
+/**
+ * @brief Apply pointer acceleration to a move-mode sample
+ *
+ * The speed is the approximate vector length of the sample (max + min/2)
+ * divided by the time since the previous sample, clamped to the poll
+ * range so the first sample after idle is not treated as slow. Cost is
+ * constant: one division, one table lookup and two multiplies.
+ *
+ * @param dev PAW3222 device pointer
+ * @param x X delta, scaled in place
+ * @param y Y delta, scaled in place
+ * @param time_us Sample timestamp in microseconds
+ */
+static void paw32xx_apply_accel(const struct device *dev, int16_t *x, int16_t *y,
+                                uint32_t time_us) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  uint32_t dt_us = time_us - data->accel_last_us;
+  uint16_t ax = abs_int16(*x);
+  uint16_t ay = abs_int16(*y);
+  uint32_t speed;
+
+  data->accel_last_us = time_us;
+
+  if (cfg->accel.type == PAW32XX_ACCEL_NONE) {
+    return;
+  }
+
+  dt_us = CLAMP(dt_us, cfg->poll_min_us, cfg->poll_max_us);
+  speed = ((uint32_t)MAX(ax, ay) + MIN(ax, ay) / 2) * USEC_PER_MSEC / dt_us;
+  speed = MIN(speed, PAW32XX_ACCEL_LUT_LEN - 1);
+
+  *x = scale_with_carry(*x, data->accel_lut[speed], &data->accel_remainder_x);
+  *y = scale_with_carry(*y, data->accel_lut[speed], &data->accel_remainder_y);
+}
+#endif
+
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+// Like paw32xx_schedule_work(), but restarts a delay that is already running
+static int paw32xx_reschedule_work(struct k_work_delayable *dwork, k_timeout_t delay) {
+#ifdef CONFIG_PAW3222_MOTION_WORKQUEUE
+  return k_work_reschedule_for_queue(&paw32xx_motion_wq, dwork, delay);
+#else
+  return k_work_reschedule(dwork, delay);
+#endif
+}
+
+// Sleep modes stay off while motion is ongoing or the mode or layer asks for it
+static inline bool paw32xx_awake_wanted(const struct device *dev) {
+  const struct paw32xx_config *cfg = dev->config;
+  const struct paw32xx_data *data = dev->data;
+
+  return cfg->force_awake || data->awake_hold || data->poll_interval_us != 0;
+}
+
+// The work handler re-evaluates the activity, so a pending sleep is dropped
+// if motion resumed in the meantime. Costs one compare when the sensor is
+// already in the wanted state.
+void paw32xx_awake_update(const struct device *dev) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  bool wanted = paw32xx_awake_wanted(dev);
+
+  if (wanted == data->force_awake_active) {
+    return;
+  }
+
+  paw32xx_reschedule_work(&data->awake_work,
+                          wanted ? K_NO_WAIT : K_MSEC(cfg->awake_idle_ms));
+}
+
+void paw32xx_awake_work_handler(struct k_work *work) {
+  struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+  struct paw32xx_data *data = CONTAINER_OF(dwork, struct paw32xx_data, awake_work);
+  bool wanted = paw32xx_awake_wanted(data->dev);
+  int ret;
+
+  if (!paw32xx_is_ready(data->dev) || !paw32xx_is_powered(data->dev) ||
+      wanted == data->force_awake_active) {
+    return;
+  }
+
+  // Only OPERATION_MODE differs, a single write thanks to the register shadow
+  ret = paw32xx_force_awake(data->dev, wanted);
+  if (ret < 0) {
+    LOG_WRN("Failed to %s sleep modes: %d", wanted ? "disable" : "enable", ret);
+    return;
+  }
+
+  data->stats.awake_toggles++;
+}
+#endif
+
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+/**
+ * @brief Take the runtime PM reference for a motion burst
+ *
+ * Cancels a pending auto-suspend and, if the sensor was released, resumes
+ * it. The wake latency is measured from here to the next input report.
+ *
+ * @param dev PAW3222 device pointer
+ *
+ * @return 0 on success, negative error code if the resume failed
+ */
+static int paw32xx_pm_motion_begin(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  uint32_t start;
+  int ret;
+
+  k_work_cancel_delayable(&data->pm_suspend_work);
+  if (data->pm_active) {
+    return 0;
+  }
+
+  start = k_cycle_get_32();
+  ret = pm_device_runtime_get(dev);
+  if (ret < 0) {
+    LOG_ERR("Runtime resume failed: %d", ret);
+    return ret;
+  }
+
+  data->pm_active = true;
+  data->pm_resume_cycles = start;
+  data->pm_wake_pending = true;
+  data->pm.resumes++;
+
+  return 0;
+}
+
+// Motion stopped, release the sensor once it stays idle for autosuspend-ms
+static void paw32xx_pm_motion_idle(const struct device *dev) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+
+  if (data->pm_active) {
+    paw32xx_schedule_work(&data->pm_suspend_work, K_MSEC(cfg->autosuspend_ms));
+  }
+}
+
+void paw32xx_pm_suspend_work_handler(struct k_work *work) {
+  struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+  struct paw32xx_data *data = CONTAINER_OF(dwork, struct paw32xx_data, pm_suspend_work);
+  int ret;
+
+  if (!data->pm_active) {
+    return;
+  }
+
+  ret = pm_device_runtime_put(data->dev);
+  if (ret < 0) {
+    LOG_ERR("Runtime suspend failed: %d", ret);
+    return;
+  }
+
+  data->pm_active = false;
+  data->pm_wake_pending = false;
+  data->pm.suspends++;
+}
+
+// Complete the wake latency measurement on the first report after a resume
+static void paw32xx_pm_record_wake(struct paw32xx_data *data) {
+  struct paw32xx_pm_stats *stats = &data->pm;
+  uint32_t wake_us;
+
+  if (!data->pm_wake_pending) {
+    return;
+  }
+  data->pm_wake_pending = false;
+
+  wake_us = k_cyc_to_us_floor32(k_cycle_get_32() - data->pm_resume_cycles);
+  stats->wake_count++;
+  stats->wake_last_us = wake_us;
+  stats->wake_max_us = MAX(stats->wake_max_us, wake_us);
+  stats->wake_total_us += wake_us;
+}
+
+int paw32xx_get_pm_stats(const struct device *dev, struct paw32xx_pm_stats *stats) {
+  const struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  *stats = data->pm;
+  irq_unlock(key);
+
+  return 0;
+}
+
+void paw32xx_reset_pm_stats(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  memset(&data->pm, 0, sizeof(data->pm));
+  irq_unlock(key);
+}
+#endif
+
+// Only the synchronizing event of a report may wait for queue space
+#ifdef CONFIG_PAW3222_REPORT_NONBLOCKING
+#define PAW32XX_REPORT_SYNC_TIMEOUT K_NO_WAIT
+#else
+#define PAW32XX_REPORT_SYNC_TIMEOUT K_FOREVER
+#endif
+
+static const uint16_t paw32xx_axis_codes[PAW32XX_AXIS_COUNT] = {
+    [PAW32XX_AXIS_X] = INPUT_REL_X,
+    [PAW32XX_AXIS_Y] = INPUT_REL_Y,
+    [PAW32XX_AXIS_WHEEL] = INPUT_REL_WHEEL,
+    [PAW32XX_AXIS_HWHEEL] = INPUT_REL_HWHEEL,
+};
+
+// Queue a delta for the next report, saturating instead of wrapping
+static inline void paw32xx_report_add(struct paw32xx_data *data,
+                                      enum paw32xx_report_axis axis, int16_t delta) {
+  int32_t total = (int32_t)data->report_pending[axis] + delta;
+
+  data->report_pending[axis] = (int16_t)CLAMP(total, INT16_MIN, INT16_MAX);
+}
+
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+static void paw32xx_latency_hist_add(struct paw32xx_latency_hist *hist, uint32_t cycles) {
+  uint32_t us = k_cyc_to_us_floor32(cycles);
+  uint32_t bucket = (us == 0) ? 0 : 32 - __builtin_clz(us);
+
+  hist->buckets[MIN(bucket, PAW32XX_LATENCY_BUCKETS - 1)]++;
+  hist->count++;
+  hist->max_us = MAX(hist->max_us, us);
+  hist->total_us += us;
+}
+
+// Fold the timestamps of the latest sample folded into the report that was
+// just sent into the histograms. With coalescing, the report stage includes
+// the wait for the end of the window.
+static void paw32xx_record_latency(struct paw32xx_data *data) {
+  uint32_t *marks = data->latency_report_marks;
+  struct paw32xx_latency_stats *stats = &data->latency;
+
+  if (!data->latency_report_pending) {
+    return;
+  }
+  data->latency_report_pending = false;
+  marks[PAW32XX_MARK_REPORT] = k_cycle_get_32();
+
+  for (int i = PAW32XX_LATENCY_QUEUE; i < PAW32XX_LATENCY_TOTAL; i++) {
+    paw32xx_latency_hist_add(&stats->stage[i], marks[i + 1] - marks[i]);
+  }
+  paw32xx_latency_hist_add(&stats->stage[PAW32XX_LATENCY_TOTAL],
+                           marks[PAW32XX_MARK_REPORT] - marks[PAW32XX_MARK_SUBMIT]);
+}
+#endif
+
+/**
+ * @brief Send the pending deltas as one input report
+ *
+ * Every non-zero axis is sent in enum paw32xx_report_axis order, the last
+ * one with the sync flag. Intermediate events never wait for queue space.
+ * With CONFIG_PAW3222_REPORT_NONBLOCKING neither does the sync event: an
+ * event the input queue cannot take stays pending, together with the axes
+ * after it, and is merged into the next report. Otherwise the sync event
+ * waits for space and only a rejected intermediate axis stays pending.
+ *
+ * @param dev PAW3222 device pointer
+ *
+ * @retval 0 Nothing left pending
+ * @retval -EAGAIN The input queue was full, deltas are still pending
+ */
+static int paw32xx_report_flush(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  bool held = false;
+  int last = -1;
+  int ret;
+
+  for (int i = 0; i < PAW32XX_AXIS_COUNT; i++) {
+    if (data->report_pending[i] != 0) {
+      last = i;
+    }
+  }
+
+  if (last < 0) {
+    return 0;
+  }
+
+  for (int i = 0; i <= last; i++) {
+    if (data->report_pending[i] == 0) {
+      continue;
+    }
+
+    ret = input_report_rel(dev, paw32xx_axis_codes[i], data->report_pending[i], i == last,
+                           i == last ? PAW32XX_REPORT_SYNC_TIMEOUT : K_NO_WAIT);
+    if (ret < 0) {
+      data->stats.report_merges++;
+#ifndef CONFIG_PAW3222_REPORT_NONBLOCKING
+      // The blocking sync event below still goes out, this axis follows later
+      if (i != last) {
+        held = true;
+        continue;
+      }
+#endif
+      return -EAGAIN;
+    }
+    data->report_pending[i] = 0;
+  }
+
+  data->stats.reports++;
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+  paw32xx_record_latency(data);
+#endif
+  if (data->boot.first_report_ms == 0) {
+    data->boot.first_report_ms = MAX(k_uptime_get_32(), 1);
+    LOG_INF("%s: first report %u ms after boot", dev->name, data->boot.first_report_ms);
+  }
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+  paw32xx_pm_record_wake(data);
+#endif
+
+  return held ? -EAGAIN : 0;
+}
+
+// Length of the report coalescing window, 0 when every sample is reported
+static uint32_t paw32xx_coalesce_window_us(const struct paw32xx_data *data) {
+  if (data->params.coalesce_us == 0) {
+    return 0;
+  }
+
+#ifdef CONFIG_PAW3222_COALESCE_BLE_INTERVAL
+  uint32_t interval_us = paw32xx_ble_interval_us();
+
+  if (interval_us > 0) {
+    return interval_us;
+  }
+#endif
+
+  return data->params.coalesce_us;
+}
+
+/**
+ * @brief Report the pending deltas, coalescing them per window
+ *
+ * Without a coalescing window the pending deltas are flushed right away.
+ * Otherwise the first sample after an idle window is flushed immediately
+ * and opens a window; samples arriving while it is open stay pending and
+ * are sent together by paw32xx_report_work_handler() when it ends.
+ *
+ * @param dev PAW3222 device pointer
+ */
+static void paw32xx_report_submit(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  uint32_t window_us = paw32xx_coalesce_window_us(data);
+
+  if (window_us == 0) {
+    paw32xx_report_flush(dev);
+    return;
+  }
+
+  if (data->report_window_open) {
+    return;
+  }
+
+  paw32xx_report_flush(dev);
+  data->report_window_open = true;
+  paw32xx_schedule_work(&data->report_work, K_USEC(window_us));
+}
+
+void paw32xx_report_work_handler(struct k_work *work) {
+  struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+  struct paw32xx_data *data = CONTAINER_OF(dwork, struct paw32xx_data, report_work);
+  uint32_t window_us = paw32xx_coalesce_window_us(data);
+  bool pending = false;
+
+  // paw32xx_power_off() closed the window, the deltas are sent after resume
+  if (!paw32xx_is_powered(data->dev)) {
+    return;
+  }
+
+  for (int i = 0; i < PAW32XX_AXIS_COUNT; i++) {
+    pending |= data->report_pending[i] != 0;
+  }
+
+  if (!pending || window_us == 0) {
+    data->report_window_open = false;
+    if (pending) {
+      paw32xx_report_flush(data->dev);
+    }
+    return;
+  }
+
+  // Keep the window running so the next report is also a window away
+  paw32xx_report_flush(data->dev);
+  paw32xx_schedule_work(&data->report_work, K_USEC(window_us));
+}
+
 /**
  * @brief Safely add to scroll accumulator with overflow protection
  *
@@ -81,6 +751,9 @@ static inline void add_to_scroll_accumulator(int16_t *accumulator, int16_t delta
  *
  * Accumulates scroll movement and generates scroll events when threshold is reached.
  * Handles both vertical and horizontal scrolling based on the input type.
+ * All whole ticks earned by the accumulator are queued for the next report
+ * as a single event of that magnitude, capped at CONFIG_PAW3222_SCROLL_MAX_TICKS. When the cap is
+ * hit, only the sub-tick remainder is kept so no backlog builds up.
  *
  * @param dev Device pointer for input reporting
  * @param accumulator Pointer to scroll accumulator
@@ -90,15 +763,23 @@ static inline void add_to_scroll_accumulator(int16_t *accumulator, int16_t delta
  */
 static void process_scroll_input(const struct device *dev, int16_t *accumulator, 
                                 int16_t scroll_delta, uint8_t threshold, bool is_horizontal) {
+  threshold = MAX(1, threshold); // Prevent division by zero
   add_to_scroll_accumulator(accumulator, scroll_delta);
-  
-  if (abs_int16(*accumulator) >= threshold) {
-    int16_t scroll_direction = (*accumulator > 0) ? 1 : -1;
-    uint16_t input_code = is_horizontal ? INPUT_REL_HWHEEL : INPUT_REL_WHEEL;
-    
-    input_report_rel(dev, input_code, scroll_direction, true, K_FOREVER);
-    *accumulator -= scroll_direction * threshold;
+
+  int16_t ticks = *accumulator / threshold;
+  if (ticks == 0) {
+    return;
   }
+
+  if (abs_int16(ticks) > CONFIG_PAW3222_SCROLL_MAX_TICKS) {
+    ticks = (ticks > 0) ? CONFIG_PAW3222_SCROLL_MAX_TICKS
+                        : -CONFIG_PAW3222_SCROLL_MAX_TICKS;
+    *accumulator %= threshold;
+  } else {
+    *accumulator -= ticks * threshold;
+  }
+
+  paw32xx_report_add(dev->data, is_horizontal ? PAW32XX_AXIS_HWHEEL : PAW32XX_AXIS_WHEEL, ticks);
 }
 
 enum paw32xx_input_mode
@@ -125,51 +806,215 @@ get_input_mode_for_current_layer(const struct device *dev) {
     }
   }
 
-  // Original layer-based switching logic
+  // Layer-based switching: one indexed load from the build-time table
   uint8_t curr_layer = zmk_keymap_highest_layer_active();
+  if (curr_layer >= PAW32XX_MAX_LAYERS) {
+    return PAW32XX_MOVE;
+  }
 
-  // High-precision horizontal scroll (snipe)
-  if (cfg->scroll_horizontal_snipe_layers &&
-      cfg->scroll_horizontal_snipe_layers_len > 0) {
-    for (size_t i = 0; i < cfg->scroll_horizontal_snipe_layers_len; i++) {
-      if (curr_layer == cfg->scroll_horizontal_snipe_layers[i]) {
-        return PAW32XX_SCROLL_HORIZONTAL_SNIPE;
-      }
-    }
+  return (enum paw32xx_input_mode)((cfg->layer_modes[curr_layer >> 1] >>
+                                    ((curr_layer & 1) * 4)) &
+                                   0x0f);
+}
+
+// CPI to program into the sensor: the target CPI, halved once per active
+// saturation reduction
+static inline int16_t paw32xx_hw_cpi(const struct paw32xx_data *data) {
+  return MAX(data->target_cpi >> data->cpi_reduction, RES_MIN);
+}
+
+// Called from the layer listener, the behavior and the shell, each on its
+// own thread: the cached mode and target CPI are swapped under mode_lock so
+// the motion path never pairs a new mode with the old CPI
+void paw32xx_update_input_mode(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  enum paw32xx_input_mode input_mode = get_input_mode_for_current_layer(dev);
+  enum paw32xx_input_mode old_mode;
+  bool cpi_changed;
+  k_spinlock_key_t key;
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+  const struct paw32xx_config *cfg = dev->config;
+  uint8_t layer = zmk_keymap_highest_layer_active();
+#endif
+
+  key = k_spin_lock(&data->mode_lock);
+
+  int16_t target_cpi = data->params.res_cpi;
+
+  if (input_mode == PAW32XX_SNIPE) {
+    // Use snipe_cpi if configured, otherwise use default from Kconfig
+    target_cpi =
+        (data->params.snipe_cpi > 0) ? data->params.snipe_cpi : CONFIG_PAW3222_SNIPE_CPI;
   }
-  // High-precision vertical scroll (snipe)
-  if (cfg->scroll_snipe_layers && cfg->scroll_snipe_layers_len > 0) {
-    for (size_t i = 0; i < cfg->scroll_snipe_layers_len; i++) {
-      if (curr_layer == cfg->scroll_snipe_layers[i]) {
-        return PAW32XX_SCROLL_SNIPE;
-      }
-    }
+
+  old_mode = data->input_mode;
+  if (old_mode != input_mode) {
+    data->stats.mode_switches++;
   }
-  // Horizontal scroll
-  if (cfg->scroll_horizontal_layers && cfg->scroll_horizontal_layers_len > 0) {
-    for (size_t i = 0; i < cfg->scroll_horizontal_layers_len; i++) {
-      if (curr_layer == cfg->scroll_horizontal_layers[i]) {
-        return PAW32XX_SCROLL_HORIZONTAL;
-      }
-    }
+
+  data->target_cpi = target_cpi;
+  data->input_mode = input_mode;
+
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+  data->awake_hold = input_mode != PAW32XX_MOVE ||
+                     (layer < PAW32XX_MAX_LAYERS && (cfg->awake_layers & BIT(layer)));
+#endif
+
+  cpi_changed = data->current_cpi != paw32xx_hw_cpi(data);
+  k_spin_unlock(&data->mode_lock, key);
+
+  if (old_mode != input_mode) {
+    LOG_DBG("input mode %d -> %d", old_mode, input_mode);
   }
-  // Vertical scroll
-  if (cfg->scroll_layers && cfg->scroll_layers_len > 0) {
-    for (size_t i = 0; i < cfg->scroll_layers_len; i++) {
-      if (curr_layer == cfg->scroll_layers[i]) {
-        return PAW32XX_SCROLL;
-      }
-    }
+
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+  paw32xx_awake_update(dev);
+#endif
+
+  // Reconfigure CPI off the motion path
+  if (cpi_changed) {
+    paw32xx_submit_work(&data->cpi_work);
   }
-  // High-precision cursor movement (snipe)
-  if (cfg->snipe_layers && cfg->snipe_layers_len > 0) {
-    for (size_t i = 0; i < cfg->snipe_layers_len; i++) {
-      if (curr_layer == cfg->snipe_layers[i]) {
-        return PAW32XX_SNIPE;
-      }
+}
+
+void paw32xx_get_params(const struct device *dev, struct paw32xx_params *params) {
+  struct paw32xx_data *data = dev->data;
+  k_spinlock_key_t key = k_spin_lock(&data->mode_lock);
+
+  *params = data->pending_params;
+  k_spin_unlock(&data->mode_lock, key);
+}
+
+void paw32xx_set_params(const struct device *dev, const struct paw32xx_params *params) {
+  struct paw32xx_data *data = dev->data;
+  k_spinlock_key_t key = k_spin_lock(&data->mode_lock);
+
+  data->pending_params = *params;
+  k_spin_unlock(&data->mode_lock, key);
+
+  paw32xx_submit_work(&data->params_work);
+}
+
+void paw32xx_params_work_handler(struct k_work *work) {
+  struct paw32xx_data *data = CONTAINER_OF(work, struct paw32xx_data, params_work);
+  k_spinlock_key_t key = k_spin_lock(&data->mode_lock);
+
+  // Serialized with motion work by the queue, the lock only keeps the copy
+  // coherent with paw32xx_set_params() and paw32xx_update_input_mode()
+  data->params = data->pending_params;
+  k_spin_unlock(&data->mode_lock, key);
+
+  paw32xx_update_input_mode(data->dev);
+}
+
+void paw32xx_cpi_work_handler(struct k_work *work) {
+  struct paw32xx_data *data = CONTAINER_OF(work, struct paw32xx_data, cpi_work);
+  const struct device *dev = data->dev;
+  k_spinlock_key_t key = k_spin_lock(&data->mode_lock);
+  int16_t hw_cpi = paw32xx_hw_cpi(data);
+  int ret;
+
+  k_spin_unlock(&data->mode_lock, key);
+
+  // paw32xx_start() and PM resume reapply the input mode once the sensor is
+  // configured
+  if (!paw32xx_is_ready(dev) || !paw32xx_is_powered(dev) || data->current_cpi == hw_cpi) {
+    return;
+  }
+
+  ret = paw32xx_set_resolution(dev, hw_cpi);
+  if (ret == 0) {
+    data->current_cpi = hw_cpi;
+  } else {
+    LOG_WRN("Failed to set CPI to %d: %d", hw_cpi, ret);
+  }
+}
+
+/**
+ * @brief Track delta saturation and adjust the hardware CPI
+ *
+ * A sample with a delta at the 8-bit limit is counted as saturated. The
+ * poll interval logic already drops to poll_min_us for such a sample; if
+ * the previous sample was polled at poll_min_us too, polling faster is no
+ * longer possible and the hardware CPI is halved instead. Once motion slows
+ * below PAW32XX_SATURATION_RESTORE_DELTA the reduction is undone step by
+ * step. The CPI change itself is applied by cpi_work.
+ *
+ * @param dev PAW3222 device pointer
+ * @param x Raw X delta of the latest sample
+ * @param y Raw Y delta of the latest sample
+ */
+static void paw32xx_check_saturation(const struct device *dev, int16_t x, int16_t y) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  int16_t magnitude = MAX(abs_int16(x), abs_int16(y));
+
+  if (magnitude >= PAW32XX_SATURATION_DELTA) {
+    data->saturation.samples++;
+
+    if (data->poll_interval_us != cfg->poll_min_us ||
+        data->cpi_reduction >= CONFIG_PAW3222_SATURATION_CPI_STEPS ||
+        (data->target_cpi >> (data->cpi_reduction + 1)) < RES_MIN) {
+      return;
     }
+
+    data->cpi_reduction++;
+    data->saturation.cpi_reductions++;
+    LOG_DBG("deltas saturated, lowering CPI to %d", paw32xx_hw_cpi(data));
+  } else if (data->cpi_reduction > 0 && magnitude < PAW32XX_SATURATION_RESTORE_DELTA) {
+    data->cpi_reduction--;
+  } else {
+    return;
   }
-  return PAW32XX_MOVE;
+
+  paw32xx_submit_work(&data->cpi_work);
+}
+
+int paw32xx_get_stats(const struct device *dev, struct paw32xx_stats *stats) {
+  const struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  *stats = data->stats;
+  irq_unlock(key);
+
+  return 0;
+}
+
+int paw32xx_get_boot_stats(const struct device *dev, struct paw32xx_boot_stats *stats) {
+  const struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  *stats = data->boot;
+  irq_unlock(key);
+
+  return 0;
+}
+
+void paw32xx_reset_stats(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  memset(&data->stats, 0, sizeof(data->stats));
+  irq_unlock(key);
+}
+
+int paw32xx_get_saturation_stats(const struct device *dev,
+                                 struct paw32xx_saturation_stats *stats) {
+  const struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  *stats = data->saturation;
+  irq_unlock(key);
+
+  return 0;
+}
+
+void paw32xx_reset_saturation_stats(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  memset(&data->saturation, 0, sizeof(data->saturation));
+  irq_unlock(key);
 }
 
 /**
@@ -207,104 +1052,292 @@ static int16_t calculate_scroll_y(int16_t x, int16_t y, uint16_t rotation) {
   }
 }
 
-void paw32xx_motion_timer_handler(struct k_timer *timer) {
-  struct paw32xx_data *data =
-      CONTAINER_OF(timer, struct paw32xx_data, motion_timer);
-  k_work_submit(&data->motion_work);
+/**
+ * @brief Pick the next motion poll interval from the latest sample
+ *
+ * Maps the larger of |x| and |y| linearly onto the configured poll range:
+ * slow drift polls at poll_max_us, deltas at or above
+ * PAW32XX_POLL_FAST_DELTA poll at poll_min_us. Faster targets are applied
+ * immediately, slower ones are approached in halving steps so that a
+ * short pause in fast motion does not drop the poll rate at once.
+ *
+ * @param cfg Device configuration holding the poll range
+ * @param prev_us Previously chosen interval, 0 if polling was idle
+ * @param x Raw X delta of the latest sample
+ * @param y Raw Y delta of the latest sample
+ *
+ * @return Next poll interval in microseconds
+ */
+static uint32_t paw32xx_next_poll_interval_us(const struct paw32xx_config *cfg,
+                                              uint32_t prev_us, int16_t x, int16_t y) {
+  int16_t magnitude = MAX(abs_int16(x), abs_int16(y));
+  uint32_t span = cfg->poll_max_us - cfg->poll_min_us;
+  uint32_t target;
+
+  if (magnitude >= PAW32XX_POLL_FAST_DELTA) {
+    target = cfg->poll_min_us;
+  } else {
+    target = cfg->poll_max_us - (span * magnitude) / PAW32XX_POLL_FAST_DELTA;
+  }
+
+  if (prev_us == 0 || target <= prev_us) {
+    return target;
+  }
+
+  return prev_us + (target - prev_us) / 2;
 }
 
-void paw32xx_motion_work_handler(struct k_work *work) {
-  struct paw32xx_data *data =
-      CONTAINER_OF(work, struct paw32xx_data, motion_work);
-  const struct device *dev = data->dev;
-  const struct paw32xx_config *cfg = dev->config;
-  uint8_t val;
-  int16_t x, y;
+uint32_t paw32xx_get_poll_interval_us(const struct device *dev) {
+  const struct paw32xx_data *data = dev->data;
+
+  return data->poll_interval_us;
+}
+
+/**
+ * @brief Queue motion work on the motion workqueue
+ *
+ * Submits to the dedicated motion workqueue when
+ * CONFIG_PAW3222_MOTION_WORKQUEUE is enabled, otherwise to the system
+ * workqueue. Records the submit time for queue-wait statistics.
+ *
+ * @param data Driver data of the instance owning the work item
+ *
+ * @note Called from interrupt context (motion GPIO and poll timer).
+ */
+static void paw32xx_submit_motion_work(struct paw32xx_data *data) {
   int ret;
-  bool irq_disabled = true;
+#if defined(CONFIG_PAW3222_QUEUE_WAIT_STATS) || defined(CONFIG_PAW3222_LATENCY_STATS)
+  uint32_t now = k_cycle_get_32();
+#endif
 
-  ret = paw32xx_read_reg(dev, PAW32XX_MOTION, &val);
-  if (ret < 0) {
-    LOG_ERR("Motion register read failed: %d", ret);
-    goto cleanup;
+  ret = paw32xx_submit_work(&data->motion_work);
+  ARG_UNUSED(ret);
+
+  // Keep the earliest timestamp if the work was already queued
+#ifdef CONFIG_PAW3222_QUEUE_WAIT_STATS
+  if (ret > 0) {
+    data->motion_submit_cycles = now;
+    data->motion_submit_pending = true;
+  }
+#endif
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+  if (ret > 0) {
+    data->latency_submit_cycles = now;
+    data->latency_submit_pending = true;
   }
+#endif
+}
 
-  if ((val & MOTION_STATUS_MOTION) == 0x00) {
-    gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_EDGE_TO_ACTIVE);
-    irq_disabled = false;
-    if (gpio_pin_get_dt(&cfg->irq_gpio) == 0) {
-      return;
-    }
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+// Take over the submit timestamp of the work item that is starting
+static void paw32xx_latency_begin(struct paw32xx_data *data) {
+  unsigned int key = irq_lock();
+
+  data->latency_valid = data->latency_submit_pending;
+  data->latency_marks[PAW32XX_MARK_SUBMIT] = data->latency_submit_cycles;
+  data->latency_submit_pending = false;
+  irq_unlock(key);
+
+  PAW32XX_LATENCY_MARK(data, PAW32XX_MARK_WORK);
+}
+
+// The sample's deltas wait for the next report. Keep its marks until
+// paw32xx_report_flush() sends them, later work runs overwrite latency_marks.
+static void paw32xx_latency_queue(struct paw32xx_data *data) {
+  if (!data->latency_valid) {
+    return;
   }
+  data->latency_valid = false;
 
-  ret = paw32xx_read_xy(dev, &x, &y);
-  if (ret < 0) {
-    LOG_ERR("XY data read failed: %d", ret);
-    goto cleanup;
+  memcpy(data->latency_report_marks, data->latency_marks, sizeof(data->latency_marks));
+  data->latency_report_pending = true;
+}
+
+int paw32xx_get_latency_stats(const struct device *dev,
+                              struct paw32xx_latency_stats *stats) {
+  const struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  *stats = data->latency;
+  irq_unlock(key);
+
+  return 0;
+}
+
+void paw32xx_reset_latency_stats(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  memset(&data->latency, 0, sizeof(data->latency));
+  irq_unlock(key);
+}
+#endif
+
+#ifdef CONFIG_PAW3222_QUEUE_WAIT_STATS
+static void paw32xx_record_queue_wait(struct paw32xx_data *data) {
+  struct paw32xx_queue_wait_stats *stats = &data->queue_wait;
+  uint32_t wait_us;
+
+  if (!data->motion_submit_pending) {
+    return;
+  }
+  data->motion_submit_pending = false;
+
+  wait_us = k_cyc_to_us_floor32(k_cycle_get_32() - data->motion_submit_cycles);
+  stats->count++;
+  stats->last_us = wait_us;
+  stats->max_us = MAX(stats->max_us, wait_us);
+  stats->total_us += wait_us;
+}
+
+int paw32xx_get_queue_wait_stats(const struct device *dev,
+                                 struct paw32xx_queue_wait_stats *stats) {
+  const struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  *stats = data->queue_wait;
+  irq_unlock(key);
+
+  return 0;
+}
+
+void paw32xx_reset_queue_wait_stats(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  memset(&data->queue_wait, 0, sizeof(data->queue_wait));
+  irq_unlock(key);
+}
+#endif
+
+#ifdef CONFIG_PAW3222_TRACE
+// Append a sample to the trace ring, overwriting the oldest entry when full
+static void paw32xx_trace_record(struct paw32xx_data *data, uint32_t time_us, uint8_t status,
+                                 enum paw32xx_input_mode mode, int16_t x, int16_t y) {
+  if (!data->trace_enabled) {
+    return;
+  }
+
+  data->trace[data->trace_count % CONFIG_PAW3222_TRACE_ENTRIES] = (struct paw32xx_trace_entry){
+      .time_us = time_us,
+      .x = x,
+      .y = y,
+      .status = status,
+      .mode = mode,
+  };
+  data->trace_count++;
+}
+
+void paw32xx_trace_enable(const struct device *dev, bool enable) {
+  struct paw32xx_data *data = dev->data;
+
+  data->trace_enabled = enable;
+}
+
+void paw32xx_trace_clear(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+
+  data->trace_count = 0;
+  irq_unlock(key);
+}
+
+size_t paw32xx_trace_len(const struct device *dev) {
+  const struct paw32xx_data *data = dev->data;
+
+  return MIN(data->trace_count, CONFIG_PAW3222_TRACE_ENTRIES);
+}
+
+int paw32xx_trace_get(const struct device *dev, size_t index,
+                      struct paw32xx_trace_entry *entry) {
+  const struct paw32xx_data *data = dev->data;
+  unsigned int key = irq_lock();
+  uint32_t count = data->trace_count;
+  size_t len = MIN(count, CONFIG_PAW3222_TRACE_ENTRIES);
+
+  if (index >= len) {
+    irq_unlock(key);
+    return -ENOENT;
+  }
+
+  *entry = data->trace[(count - len + index) % CONFIG_PAW3222_TRACE_ENTRIES];
+  irq_unlock(key);
+
+  return 0;
+}
+
+void paw32xx_trace_log(const struct device *dev) {
+  struct paw32xx_data *data = dev->data;
+  struct paw32xx_trace_entry entry;
+  bool enabled = data->trace_enabled;
+
+  // Freeze the ring so the dump is one consistent window
+  data->trace_enabled = false;
+  LOG_INF("%s: %u trace entries", dev->name, (unsigned int)paw32xx_trace_len(dev));
+  for (size_t i = 0; paw32xx_trace_get(dev, i, &entry) == 0; i++) {
+    LOG_INF(PAW32XX_TRACE_FMT, PAW32XX_TRACE_ARGS(&entry));
   }
+  data->trace_enabled = enabled;
+}
+#endif
+
+void paw32xx_process_sample(const struct device *dev, enum paw32xx_input_mode input_mode,
+                            int16_t x, int16_t y, uint32_t time_us) {
+  struct paw32xx_data *data = dev->data;
 
   // For scroll modes, we need to transform coordinates based on rotation
   // to ensure y-axis movement always triggers scroll regardless of sensor
   // orientation
-  int16_t scroll_y = calculate_scroll_y(x, y, cfg->rotation);
+  int16_t scroll_y = calculate_scroll_y(x, y, data->params.rotation);
 
   // Debug log
-  LOG_DBG("x=%d y=%d scroll_y=%d rotation=%d", x, y, scroll_y, cfg->rotation);
-
-  enum paw32xx_input_mode input_mode = get_input_mode_for_current_layer(dev);
-
-  // CPI Switching
-  int16_t target_cpi = cfg->res_cpi;
-  if (input_mode == PAW32XX_SNIPE) {
-    // Use snipe_cpi if configured, otherwise use default from Kconfig
-    target_cpi =
-        (cfg->snipe_cpi > 0) ? cfg->snipe_cpi : CONFIG_PAW3222_SNIPE_CPI;
-  }
-  if (data->current_cpi != target_cpi) {
-    ret = paw32xx_set_resolution(dev, target_cpi);
-    if (ret == 0) {
-      data->current_cpi = target_cpi;
-    } else {
-      LOG_WRN("Failed to set CPI to %d: %d", target_cpi, ret);
-    }
-  }
+  LOG_DBG("x=%d y=%d scroll_y=%d rotation=%d", x, y, scroll_y, data->params.rotation);
 
   switch (input_mode) {
   case PAW32XX_MOVE: { // Normal cursor movement
-    // Send raw X/Y movement - let input-processors handle rotation
-    input_report_rel(data->dev, INPUT_REL_X, x, false, K_NO_WAIT);
-    input_report_rel(data->dev, INPUT_REL_Y, y, true, K_FOREVER);
+    int16_t move_x = x;
+    int16_t move_y = y;
+
+#ifdef CONFIG_PAW3222_ACCEL
+    // Accelerate a copy so the poll rate still follows the sensor counts
+    paw32xx_apply_accel(dev, &move_x, &move_y, time_us);
+#endif
+    // Send X/Y movement - let input-processors handle rotation
+    paw32xx_report_add(data, PAW32XX_AXIS_X, move_x);
+    paw32xx_report_add(data, PAW32XX_AXIS_Y, move_y);
     break;
   }
   case PAW32XX_SNIPE: { // High-precision cursor movement
     // Apply additional precision scaling for snipe mode
     // Reduce movement by configurable divisor for ultra-precision
-    uint8_t divisor = MAX(1, cfg->snipe_divisor); // Prevent division by zero
-    int16_t snipe_x = x / divisor;
-    int16_t snipe_y = y / divisor;
+    uint8_t divisor = MAX(1, data->params.snipe_divisor); // Prevent division by zero
+    int16_t snipe_x = divide_with_carry(x, divisor, &data->snipe_remainder_x);
+    int16_t snipe_y = divide_with_carry(y, divisor, &data->snipe_remainder_y);
 
-    input_report_rel(data->dev, INPUT_REL_X, snipe_x, false, K_NO_WAIT);
-    input_report_rel(data->dev, INPUT_REL_Y, snipe_y, true, K_FOREVER);
+    paw32xx_report_add(data, PAW32XX_AXIS_X, snipe_x);
+    paw32xx_report_add(data, PAW32XX_AXIS_Y, snipe_y);
     break;
   }
   case PAW32XX_SCROLL: // Vertical scroll
-    process_scroll_input(data->dev, &data->scroll_accumulator, scroll_y, cfg->scroll_tick, false);
+    process_scroll_input(dev, &data->scroll_accumulator, scroll_y, data->params.scroll_tick, false);
     break;
   case PAW32XX_SCROLL_HORIZONTAL: // Horizontal scroll
-    process_scroll_input(data->dev, &data->scroll_accumulator, scroll_y, cfg->scroll_tick, true);
+    process_scroll_input(dev, &data->scroll_accumulator, scroll_y, data->params.scroll_tick, true);
     break;
   case PAW32XX_SCROLL_SNIPE: // High-precision vertical scroll
     {
-      uint8_t divisor = MAX(1, cfg->scroll_snipe_divisor);
-      int16_t snipe_scroll_y = scroll_y / divisor;
-      process_scroll_input(data->dev, &data->scroll_accumulator, snipe_scroll_y, cfg->scroll_snipe_tick, false);
+      uint8_t divisor = MAX(1, data->params.scroll_snipe_divisor);
+      int16_t snipe_scroll_y =
+          divide_with_carry(scroll_y, divisor, &data->scroll_snipe_remainder);
+      process_scroll_input(dev, &data->scroll_accumulator, snipe_scroll_y, data->params.scroll_snipe_tick, false);
     }
     break;
   case PAW32XX_SCROLL_HORIZONTAL_SNIPE: // High-precision horizontal scroll
     {
-      uint8_t divisor = MAX(1, cfg->scroll_snipe_divisor);
-      int16_t snipe_scroll_y = scroll_y / divisor;
-      process_scroll_input(data->dev, &data->scroll_accumulator, snipe_scroll_y, cfg->scroll_snipe_tick, true);
+      uint8_t divisor = MAX(1, data->params.scroll_snipe_divisor);
+      int16_t snipe_scroll_y =
+          divide_with_carry(scroll_y, divisor, &data->scroll_snipe_remainder);
+      process_scroll_input(dev, &data->scroll_accumulator, snipe_scroll_y, data->params.scroll_snipe_tick, true);
     }
     break;
 
@@ -313,13 +1346,141 @@ void paw32xx_motion_work_handler(struct k_work *work) {
     break;
   }
 
-  k_timer_start(&data->motion_timer, K_MSEC(15), K_NO_WAIT);
+  paw32xx_report_submit(dev);
+}
+
+void paw32xx_motion_timer_handler(struct k_timer *timer) {
+  struct paw32xx_data *data =
+      CONTAINER_OF(timer, struct paw32xx_data, motion_timer);
+  paw32xx_submit_motion_work(data);
+}
+
+void paw32xx_motion_work_handler(struct k_work *work) {
+  struct paw32xx_data *data =
+      CONTAINER_OF(work, struct paw32xx_data, motion_work);
+  const struct device *dev = data->dev;
+  const struct paw32xx_config *cfg = dev->config;
+  uint32_t time_us;
+  uint8_t val;
+  int16_t x, y;
+  int ret;
+  bool irq_disabled = true;
+
+  // Submitted while a power-gating suspend was in progress; resume re-arms
+  // the motion interrupt
+  if (!paw32xx_is_powered(dev)) {
+    return;
+  }
+
+#ifdef CONFIG_PAW3222_QUEUE_WAIT_STATS
+  paw32xx_record_queue_wait(data);
+#endif
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+  paw32xx_latency_begin(data);
+#endif
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+  if (paw32xx_pm_motion_begin(dev) < 0) {
+    goto cleanup;
+  }
+#endif
+
+  // Motion status and both deltas in one SPI transaction
+  ret = paw32xx_read_motion_burst(dev, &val, &x, &y);
+  if (ret < 0) {
+    LOG_ERR("Motion burst read failed: %d", ret);
+    goto cleanup;
+  }
+  PAW32XX_LATENCY_MARK(data, PAW32XX_MARK_SPI);
+
+  if ((val & MOTION_STATUS_MOTION) == 0x00) {
+    gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+    irq_disabled = false;
+    if (gpio_pin_get_dt(&cfg->irq_gpio) == 0) {
+#ifdef CONFIG_PAW3222_TRACE
+      // Mark the end of the stroke in the trace
+      paw32xx_trace_record(data, k_cyc_to_us_floor32(k_cycle_get_32()), val,
+                           data->input_mode, x, y);
+#endif
+      // An open coalescing window sends (and retries) the pending deltas
+      if (!data->report_window_open && paw32xx_report_flush(dev) < 0) {
+        // Keep retrying held-back deltas even though the ball stopped
+        data->poll_interval_us = cfg->poll_max_us;
+        k_timer_start(&data->motion_timer, K_USEC(data->poll_interval_us), K_NO_WAIT);
+        return;
+      }
+      data->poll_interval_us = 0;
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+      paw32xx_pm_motion_idle(dev);
+#endif
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+      paw32xx_awake_update(dev);
+#endif
+      if (data->cpi_reduction > 0) {
+        // Motion stopped, start the next movement at full CPI
+        data->cpi_reduction = 0;
+        paw32xx_submit_work(&data->cpi_work);
+      }
+      return;
+    }
+    // Motion arrived after the status was sampled, fetch the new deltas
+    ret = paw32xx_read_motion_burst(dev, &val, &x, &y);
+    if (ret < 0) {
+      LOG_ERR("Motion burst read failed: %d", ret);
+      goto cleanup;
+    }
+    PAW32XX_LATENCY_MARK(data, PAW32XX_MARK_SPI);
+  }
+
+  // Mode and CPI are cached by paw32xx_update_input_mode() on layer or
+  // behavior changes, so the motion path does not query the keymap. Both are
+  // read under mode_lock so a sample never sees half of a mode change.
+  k_spinlock_key_t key = k_spin_lock(&data->mode_lock);
+  enum paw32xx_input_mode input_mode = data->input_mode;
+  int16_t target_cpi = data->target_cpi;
+
+  k_spin_unlock(&data->mode_lock, key);
+
+  paw32xx_check_saturation(dev, x, y);
+
+  // The hardware CPI differs from the target while a CPI change is still
+  // queued on cpi_work or while it is lowered to avoid saturation: report
+  // the sample as if it had been taken at the target CPI. Deltas and CPI
+  // steps are at most 127, so the scaled delta fits in int16_t.
+  if (data->current_cpi > 0 && data->current_cpi != target_cpi) {
+    int16_t target_step = target_cpi / RES_STEP;
+    uint8_t current_step = data->current_cpi / RES_STEP;
+
+    x = divide_with_carry(x * target_step, current_step, &data->cpi_remainder_x);
+    y = divide_with_carry(y * target_step, current_step, &data->cpi_remainder_y);
+  }
+  data->stats.samples++;
+  PAW32XX_LATENCY_MARK(data, PAW32XX_MARK_MODE);
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+  paw32xx_latency_queue(data);
+#endif
+
+  time_us = k_cyc_to_us_floor32(k_cycle_get_32());
+#ifdef CONFIG_PAW3222_TRACE
+  paw32xx_trace_record(data, time_us, val, input_mode, x, y);
+#endif
+  paw32xx_process_sample(dev, input_mode, x, y, time_us);
+
+  data->poll_interval_us =
+      paw32xx_next_poll_interval_us(cfg, data->poll_interval_us, x, y);
+  LOG_DBG("next poll in %u us", data->poll_interval_us);
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+  paw32xx_awake_update(dev);
+#endif
+  k_timer_start(&data->motion_timer, K_USEC(data->poll_interval_us), K_NO_WAIT);
   return;
 
 cleanup:
   if (irq_disabled) {
     gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_EDGE_TO_ACTIVE);
   }
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+  paw32xx_pm_motion_idle(dev);
+#endif
 }
 
 void paw32xx_motion_handler(const struct device *gpio_dev,
@@ -332,5 +1493,5 @@ void paw32xx_motion_handler(const struct device *gpio_dev,
 
   gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_DISABLE);
   k_timer_stop(&data->motion_timer);
-  k_work_submit(&data->motion_work);
+  paw32xx_submit_motion_work(data);
 }
\ No newline at end of file
@@ -16,70 +16,214 @@
 #include <zephyr/devicetree.h>
 
 #include "paw3222.h"
+#include "paw3222_input.h"
 #include "paw3222_regs.h"
 #include "paw3222_spi.h"
 #include "paw3222_power.h"
 
 LOG_MODULE_DECLARE(paw32xx);
 
-int paw32xx_set_resolution(const struct device *dev, uint16_t res_cpi) {
-    uint8_t val;
-    int ret;
-
+// Append the CPI_X/CPI_Y writes for res_cpi to a register sequence
+static int paw32xx_seq_add_resolution(struct paw32xx_reg_write *seq, size_t *len,
+                                      uint16_t res_cpi) {
     if (!IN_RANGE(res_cpi, RES_MIN, RES_MAX)) {
         LOG_ERR("res_cpi out of range: %d", res_cpi);
         return -EINVAL;
     }
 
-    val = res_cpi / RES_STEP;
+    seq[(*len)++] = (struct paw32xx_reg_write){PAW32XX_CPI_X, res_cpi / RES_STEP};
+    seq[(*len)++] = (struct paw32xx_reg_write){PAW32XX_CPI_Y, res_cpi / RES_STEP};
 
-    ret = paw32xx_write_reg(dev, PAW32XX_WRITE_PROTECT, WRITE_PROTECT_DISABLE);
-    if (ret < 0) {
-        return ret;
+    return 0;
+}
+
+// SLEEP1..SLEEP3 value of a power profile. The balanced profile keeps the
+// timing the sensor came out of reset with.
+static uint8_t paw32xx_profile_sleep(const struct paw32xx_data *data,
+                                     enum paw32xx_power_profile profile, int index) {
+    switch (profile) {
+    case PAW32XX_POWER_LATENCY:
+        return FIELD_PREP(SLEEP_FREQ_MASK, 0) | FIELD_PREP(SLEEP_ETM_MASK, 0xf);
+    case PAW32XX_POWER_BATTERY:
+        return FIELD_PREP(SLEEP_FREQ_MASK, 0xf) | FIELD_PREP(SLEEP_ETM_MASK, 0);
+    default:
+        return data->sleep_defaults[index];
     }
+}
 
-    ret = paw32xx_write_reg(dev, PAW32XX_CPI_X, val);
-    if (ret < 0) {
-        return ret;
+// Append the SLEEP1..SLEEP3 and OPERATION_MODE writes for a power profile and
+// force-awake state to a register sequence. Registers already in that state
+// are dropped by paw32xx_write_seq(), so a force-awake toggle costs only the
+// OPERATION_MODE write.
+static int paw32xx_seq_add_power(const struct device *dev, struct paw32xx_reg_write *seq,
+                                 size_t *len, enum paw32xx_power_profile profile,
+                                 bool force_awake) {
+    const struct paw32xx_data *data = dev->data;
+    uint8_t op_mode;
+    int ret;
+
+    if (!paw32xx_shadow_get(dev, PAW32XX_OPERATION_MODE, &op_mode)) {
+        ret = paw32xx_read_reg(dev, PAW32XX_OPERATION_MODE, &op_mode);
+        if (ret < 0) {
+            return ret;
+        }
     }
 
-    ret = paw32xx_write_reg(dev, PAW32XX_CPI_Y, val);
+    if (data->sleep_defaults_valid) {
+        for (int i = 0; i < ARRAY_SIZE(data->sleep_defaults); i++) {
+            seq[(*len)++] = (struct paw32xx_reg_write){
+                PAW32XX_SLEEP1 + i, paw32xx_profile_sleep(data, profile, i)};
+        }
+    }
+
+    op_mode &= ~OPERATION_MODE_SLP_MASK;
+    if (!force_awake) {
+        op_mode |= profile == PAW32XX_POWER_LATENCY ? OPERATION_MODE_SLP_ENH
+                                                    : OPERATION_MODE_SLP_MASK;
+    }
+    seq[(*len)++] = (struct paw32xx_reg_write){PAW32XX_OPERATION_MODE, op_mode};
+
+    return 0;
+}
+
+bool paw32xx_is_ready(const struct device *dev) {
+    struct paw32xx_data *data = dev->data;
+
+    return atomic_get(&data->init_state) == PAW32XX_INIT_DONE;
+}
+
+bool paw32xx_is_powered(const struct device *dev) {
+#ifdef CONFIG_PM_DEVICE
+    struct paw32xx_data *data = dev->data;
+
+    return atomic_get(&data->powered_off) == 0;
+#else
+    ARG_UNUSED(dev);
+
+    return true;
+#endif
+}
+
+int paw32xx_ready_status(const struct device *dev) {
+    struct paw32xx_data *data = dev->data;
+
+    switch (atomic_get(&data->init_state)) {
+    case PAW32XX_INIT_DONE:
+        return 0;
+    case PAW32XX_INIT_FAILED:
+        return -EIO;
+    default:
+        return -EAGAIN;
+    }
+}
+
+int paw32xx_set_resolution(const struct device *dev, uint16_t res_cpi) {
+    struct paw32xx_reg_write seq[2];
+    size_t len = 0;
+    int ret;
+
+    ret = paw32xx_ready_status(dev);
     if (ret < 0) {
         return ret;
     }
 
-    ret = paw32xx_write_reg(dev, PAW32XX_WRITE_PROTECT, WRITE_PROTECT_ENABLE);
+    ret = paw32xx_seq_add_resolution(seq, &len, res_cpi);
     if (ret < 0) {
         return ret;
     }
 
-    return 0;
+    return paw32xx_write_seq(dev, seq, len);
 }
 
 int paw32xx_force_awake(const struct device *dev, bool enable) {
-    uint8_t val = enable ? 0 : OPERATION_MODE_SLP_MASK;
+    struct paw32xx_data *data = dev->data;
+    struct paw32xx_reg_write seq[4];
+    size_t len = 0;
     int ret;
 
-    ret = paw32xx_write_reg(dev, PAW32XX_WRITE_PROTECT, WRITE_PROTECT_DISABLE);
+    ret = paw32xx_ready_status(dev);
     if (ret < 0) {
         return ret;
     }
 
-    ret = paw32xx_update_reg(dev, PAW32XX_OPERATION_MODE, OPERATION_MODE_SLP_MASK, val);
-    if (ret < 0) {
-        return ret;
+    // OPERATION_MODE is read from the shadow and written back as a whole
+    paw32xx_bus_lock(dev);
+    ret = paw32xx_seq_add_power(dev, seq, &len, data->power_profile, enable);
+    if (ret == 0) {
+        ret = paw32xx_write_seq(dev, seq, len);
+    }
+    if (ret == 0) {
+        data->force_awake_active = enable;
+    }
+    paw32xx_bus_unlock(dev);
+
+    return ret;
+}
+
+int paw32xx_set_power_profile(const struct device *dev, enum paw32xx_power_profile profile) {
+    struct paw32xx_data *data = dev->data;
+    struct paw32xx_reg_write seq[4];
+    size_t len = 0;
+    int ret;
+
+    if (profile >= PAW32XX_POWER_PROFILE_COUNT) {
+        LOG_ERR("Invalid power profile: %d", profile);
+        return -EINVAL;
     }
 
-    ret = paw32xx_write_reg(dev, PAW32XX_WRITE_PROTECT, WRITE_PROTECT_ENABLE);
+    ret = paw32xx_ready_status(dev);
     if (ret < 0) {
         return ret;
     }
 
-    return 0;
+    paw32xx_bus_lock(dev);
+    ret = paw32xx_seq_add_power(dev, seq, &len, profile, data->force_awake_active);
+    if (ret == 0) {
+        ret = paw32xx_write_seq(dev, seq, len);
+    }
+    if (ret == 0) {
+        data->power_profile = profile;
+    }
+    paw32xx_bus_unlock(dev);
+
+    return ret;
+}
+
+int paw32xx_wait_ready(const struct device *dev, uint32_t min_ms) {
+    const struct paw32xx_config *cfg = dev->config;
+    int64_t deadline;
+    uint8_t val = 0;
+    int ret;
+
+    if (min_ms > 0) {
+        k_sleep(K_MSEC(min_ms));
+    }
+
+    // The sensor answers SPI reads with its product ID as soon as it is up,
+    // which is usually well before any fixed worst-case delay would expire
+    deadline = k_uptime_get() + cfg->ready_timeout_ms;
+    while (true) {
+        ret = paw32xx_read_reg(dev, PAW32XX_PRODUCT_ID1, &val);
+        if (ret == 0 && val == PRODUCT_ID_PAW32XX) {
+            return 0;
+        }
+
+        if (k_uptime_get() >= deadline) {
+            LOG_ERR("Sensor not ready after %u ms (product id %02x)", cfg->ready_timeout_ms,
+                    val);
+            return ret < 0 ? ret : -ETIMEDOUT;
+        }
+
+        k_sleep(K_USEC(READY_POLL_US));
+    }
 }
 
 int paw32xx_configure(const struct device *dev) {
     const struct paw32xx_config *cfg = dev->config;
+    struct paw32xx_data *data = dev->data;
+    struct paw32xx_reg_write seq[6];
+    size_t len = 0;
+    bool set_cpi = false;
     uint8_t val;
     int ret;
 
@@ -103,6 +247,11 @@ int paw32xx_configure(const struct device *dev) {
         return -EINVAL;
     }
 
+    if (cfg->poll_min_us == 0 || cfg->poll_min_us > cfg->poll_max_us) {
+        LOG_ERR("Invalid poll interval range %u-%u us", cfg->poll_min_us, cfg->poll_max_us);
+        return -EINVAL;
+    }
+
     ret = paw32xx_read_reg(dev, PAW32XX_PRODUCT_ID1, &val);
     if (ret < 0) {
         return ret;
@@ -120,56 +269,178 @@ int paw32xx_configure(const struct device *dev) {
 
     k_sleep(K_MSEC(RESET_DELAY_MS));
 
-    if (cfg->res_cpi > 0) {
-        paw32xx_set_resolution(dev, cfg->res_cpi);
+    ret = paw32xx_shadow_refresh(dev);
+    if (ret < 0) {
+        return ret;
+    }
+
+    // The balanced profile restores the sleep timing read right after reset
+    if (!data->sleep_defaults_valid) {
+        for (int i = 0; i < ARRAY_SIZE(data->sleep_defaults); i++) {
+            if (!paw32xx_shadow_get(dev, PAW32XX_SLEEP1 + i, &data->sleep_defaults[i])) {
+                return -EIO;
+            }
+        }
+        data->sleep_defaults_valid = true;
+    }
+
+    // CPI and sleep configuration share a single write-protect window
+    if (data->params.res_cpi > 0) {
+        set_cpi = paw32xx_seq_add_resolution(seq, &len, data->params.res_cpi) == 0;
     }
 
-    paw32xx_force_awake(dev, cfg->force_awake);
+    ret = paw32xx_seq_add_power(dev, seq, &len, data->power_profile, cfg->force_awake);
+    if (ret < 0) {
+        return ret;
+    }
+
+    ret = paw32xx_write_seq(dev, seq, len);
+    if (ret < 0) {
+        LOG_ERR("Failed to write sensor configuration: %d", ret);
+        return ret;
+    }
+
+    if (set_cpi) {
+        data->current_cpi = data->params.res_cpi;
+    }
+    data->force_awake_active = cfg->force_awake;
 
     return 0;
 }
 
 #ifdef CONFIG_PM_DEVICE
+// Cut the supply of a power-gated sensor. The motion line of an unpowered
+// sensor is undefined, so polling and the interrupt are stopped first, and
+// driver work still using the bus is waited for.
+static int paw32xx_power_off(const struct device *dev) {
+    const struct paw32xx_config *cfg = dev->config;
+    struct paw32xx_data *data = dev->data;
+    struct k_work_sync sync;
+    int ret;
+
+    // Work submitted from here on sees the flag and returns without SPI
+    atomic_set(&data->powered_off, 1);
+
+    // A running motion work item may still re-arm the interrupt or the poll
+    // timer, so both are stopped only once it has finished
+    k_work_cancel_sync(&data->motion_work, &sync);
+    k_work_cancel_sync(&data->cpi_work, &sync);
+    k_work_cancel_delayable_sync(&data->report_work, &sync);
+    // Deltas of a cancelled window go out with the first report after resume
+    data->report_window_open = false;
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+    k_work_cancel_delayable_sync(&data->awake_work, &sync);
+#endif
+
+    gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_DISABLE);
+    k_timer_stop(&data->motion_timer);
+
+    ret = gpio_pin_set_dt(&cfg->power_gpio, 0);
+    if (ret < 0) {
+        LOG_ERR("Failed to disable power: %d", ret);
+        return ret;
+    }
+
+    paw32xx_shadow_invalidate(dev);
+
+    return 0;
+}
+
+// Power a gated sensor back up. It comes back with reset defaults, so the
+// full configuration is written again and the CPI for the current mode is
+// reapplied before motion interrupts are re-enabled.
+static int paw32xx_power_on(const struct device *dev) {
+    const struct paw32xx_config *cfg = dev->config;
+    struct paw32xx_data *data = dev->data;
+    int ret;
+
+    // Never cut, e.g. the first runtime PM reference taken by paw32xx_start()
+    if (paw32xx_is_powered(dev)) {
+        return 0;
+    }
+
+    ret = gpio_pin_set_dt(&cfg->power_gpio, 1);
+    if (ret < 0) {
+        LOG_ERR("Failed to enable power: %d", ret);
+        return ret;
+    }
+
+    ret = paw32xx_wait_ready(dev, cfg->power_on_ms);
+    if (ret < 0) {
+        return ret;
+    }
+
+    data->current_cpi = -1;
+    ret = paw32xx_configure(dev);
+    if (ret < 0) {
+        LOG_ERR("Failed to restore configuration: %d", ret);
+        return ret;
+    }
+
+    atomic_set(&data->powered_off, 0);
+    paw32xx_update_input_mode(dev);
+
+    return gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+}
+
 int paw32xx_pm_action(const struct device *dev, enum pm_device_action action) {
-#if DT_INST_NODE_HAS_PROP(0, power_gpios)
     const struct paw32xx_config *cfg = dev->config;
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+    struct paw32xx_data *data = dev->data;
 #endif
+    bool power_gated = cfg->power_gpio.port != NULL;
     int ret;
-    uint8_t val;
+
+    // Deferred initialization has not configured the sensor yet, or failed
+    ret = paw32xx_ready_status(dev);
+    if (ret < 0) {
+        return ret == -EAGAIN ? -EBUSY : ret;
+    }
+
+    // A wakeup source must keep detecting motion while suspended: the
+    // sensor stays powered and only drops into its own sleep modes, so the
+    // armed motion interrupt can resume it
+    if (pm_device_wakeup_is_enabled(dev)) {
+        switch (action) {
+        case PM_DEVICE_ACTION_SUSPEND:
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+            // A queued wake-up must not undo the release below
+            k_work_cancel_delayable(&data->awake_work);
+#endif
+            return paw32xx_force_awake(dev, false);
+        case PM_DEVICE_ACTION_RESUME:
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+            // Restore what the current activity asks for rather than the
+            // static force-awake property; no bus write if that is to sleep
+            paw32xx_awake_update(dev);
+            return 0;
+#else
+            return paw32xx_force_awake(dev, cfg->force_awake);
+#endif
+        default:
+            return -ENOTSUP;
+        }
+    }
 
     switch (action) {
     case PM_DEVICE_ACTION_SUSPEND:
-        val = CONFIGURATION_PD_ENH;
-        ret = paw32xx_update_reg(dev, PAW32XX_CONFIGURATION, CONFIGURATION_PD_ENH, val);
+        ret = paw32xx_update_reg(dev, PAW32XX_CONFIGURATION, CONFIGURATION_PD_ENH,
+                                 CONFIGURATION_PD_ENH);
         if (ret < 0) {
             return ret;
         }
 
-#if DT_INST_NODE_HAS_PROP(0, power_gpios)
-        if (gpio_is_ready_dt(&cfg->power_gpio)) {
-            ret = gpio_pin_set_dt(&cfg->power_gpio, 0);
-            if (ret < 0) {
-                LOG_ERR("Failed to disable power: %d", ret);
-                return ret;
-            }
+        if (power_gated) {
+            return paw32xx_power_off(dev);
         }
-#endif
         break;
 
     case PM_DEVICE_ACTION_RESUME:
-#if DT_INST_NODE_HAS_PROP(0, power_gpios)
-        if (gpio_is_ready_dt(&cfg->power_gpio)) {
-            ret = gpio_pin_set_dt(&cfg->power_gpio, 1);
-            if (ret < 0) {
-                LOG_ERR("Failed to enable power: %d", ret);
-                return ret;
-            }
-            k_sleep(K_MSEC(10));
+        if (power_gated) {
+            return paw32xx_power_on(dev);
         }
-#endif
 
-        val = 0;
-        ret = paw32xx_update_reg(dev, PAW32XX_CONFIGURATION, CONFIGURATION_PD_ENH, val);
+        ret = paw32xx_update_reg(dev, PAW32XX_CONFIGURATION, CONFIGURATION_PD_ENH, 0);
         if (ret < 0) {
             return ret;
         }
@@ -181,4 +452,4 @@ int paw32xx_pm_action(const struct device *dev, enum pm_device_action action) {
 
     return 0;
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,454 @@
+/*
+ * Copyright 2025 nuovotaka
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/util.h>
+
+#include "paw3222.h"
+#include "paw3222_input.h"
+#include "paw3222_power.h"
+#include "paw3222_regs.h"
+#include "paw3222_spi.h"
+
+#define PAW32XX_SHELL_REG_MAX 0x7f
+
+static const struct device *paw32xx_shell_device(const struct shell *sh, const char *name) {
+    const struct device *dev;
+
+    for (size_t i = 0; (dev = paw32xx_get_device(i)) != NULL; i++) {
+        if (strcmp(dev->name, name) == 0) {
+            if (!device_is_ready(dev)) {
+                shell_error(sh, "%s is not ready", name);
+                return NULL;
+            }
+            if (paw32xx_ready_status(dev) == -EAGAIN) {
+                shell_error(sh, "%s is still initializing", name);
+                return NULL;
+            }
+            if (!paw32xx_is_ready(dev)) {
+                shell_error(sh, "%s failed to initialize", name);
+                return NULL;
+            }
+            return dev;
+        }
+    }
+
+    shell_error(sh, "%s is not a PAW3222 device", name);
+    return NULL;
+}
+
+static int paw32xx_shell_parse(const struct shell *sh, const char *arg, long min, long max,
+                               long *value) {
+    char *end;
+
+    *value = strtol(arg, &end, 0);
+    if (*end != '\0' || *value < min || *value > max) {
+        shell_error(sh, "invalid value %s (expected %ld-%ld)", arg, min, max);
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+static int cmd_list(const struct shell *sh, size_t argc, char **argv) {
+    const struct device *dev;
+
+    ARG_UNUSED(argc);
+    ARG_UNUSED(argv);
+
+    for (size_t i = 0; (dev = paw32xx_get_device(i)) != NULL; i++) {
+        shell_print(sh, "%s%s", dev->name, device_is_ready(dev) ? "" : " (not ready)");
+    }
+
+    return 0;
+}
+
+static int cmd_reg_read(const struct shell *sh, size_t argc, char **argv) {
+    const struct device *dev = paw32xx_shell_device(sh, argv[1]);
+    long addr;
+    uint8_t value;
+    int ret;
+
+    ARG_UNUSED(argc);
+
+    if (dev == NULL) {
+        return -ENODEV;
+    }
+
+    ret = paw32xx_shell_parse(sh, argv[2], 0, PAW32XX_SHELL_REG_MAX, &addr);
+    if (ret < 0) {
+        return ret;
+    }
+
+    ret = paw32xx_read_reg(dev, addr, &value);
+    if (ret < 0) {
+        shell_error(sh, "read failed: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "0x%02lx: 0x%02x", addr, value);
+
+    return 0;
+}
+
+static int cmd_reg_write(const struct shell *sh, size_t argc, char **argv) {
+    const struct device *dev = paw32xx_shell_device(sh, argv[1]);
+    struct paw32xx_reg_write write;
+    long addr, value;
+    int ret;
+
+    ARG_UNUSED(argc);
+
+    if (dev == NULL) {
+        return -ENODEV;
+    }
+
+    ret = paw32xx_shell_parse(sh, argv[2], 0, PAW32XX_SHELL_REG_MAX, &addr);
+    if (ret < 0) {
+        return ret;
+    }
+
+    ret = paw32xx_shell_parse(sh, argv[3], 0, UINT8_MAX, &value);
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (addr == PAW32XX_WRITE_PROTECT) {
+        shell_error(sh, "write protection is handled by the driver");
+        return -EINVAL;
+    }
+
+    // The motion path rescales and tracks saturation against the CPI the
+    // driver last programmed, and a reset drops the whole configuration
+    if (addr == PAW32XX_CPI_X || addr == PAW32XX_CPI_Y) {
+        shell_error(sh, "use \"paw3222 param %s cpi <value>\" to change the resolution",
+                    dev->name);
+        return -EINVAL;
+    }
+    if (addr == PAW32XX_CONFIGURATION) {
+        shell_error(sh, "the configuration register is owned by the driver");
+        return -EINVAL;
+    }
+
+    // Goes through the write sequence so protected registers can be written
+    // and the register shadow stays coherent
+    write.addr = addr;
+    write.value = value;
+    ret = paw32xx_write_seq(dev, &write, 1);
+    if (ret < 0) {
+        shell_error(sh, "write failed: %d", ret);
+        return ret;
+    }
+
+    return 0;
+}
+
+static void paw32xx_shell_print_params(const struct shell *sh, const struct device *dev) {
+    const struct paw32xx_data *data = dev->data;
+    struct paw32xx_params params;
+
+    paw32xx_get_params(dev, &params);
+
+    shell_print(sh, "cpi:                  %d (current %d)", params.res_cpi, data->current_cpi);
+    shell_print(sh, "snipe-cpi:            %d", params.snipe_cpi);
+    shell_print(sh, "snipe-divisor:        %u", params.snipe_divisor);
+    shell_print(sh, "scroll-snipe-divisor: %u", params.scroll_snipe_divisor);
+    shell_print(sh, "scroll-tick:          %u", params.scroll_tick);
+    shell_print(sh, "scroll-snipe-tick:    %u", params.scroll_snipe_tick);
+    shell_print(sh, "rotation:             %u", params.rotation);
+    shell_print(sh, "coalesce-us:          %u", params.coalesce_us);
+}
+
+static int paw32xx_shell_set_param(const struct shell *sh, struct paw32xx_params *params,
+                                   const char *name, const char *arg) {
+    long value;
+    int ret;
+
+    if (strcmp(name, "cpi") == 0 || strcmp(name, "snipe-cpi") == 0) {
+        ret = paw32xx_shell_parse(sh, arg, RES_MIN, RES_MAX, &value);
+        if (ret < 0) {
+            return ret;
+        }
+        if (strcmp(name, "cpi") == 0) {
+            params->res_cpi = value;
+        } else {
+            params->snipe_cpi = value;
+        }
+        return 0;
+    }
+
+    if (strcmp(name, "rotation") == 0) {
+        ret = paw32xx_shell_parse(sh, arg, 0, 270, &value);
+        if (ret < 0) {
+            return ret;
+        }
+        if (value % 90 != 0) {
+            shell_error(sh, "rotation must be 0, 90, 180 or 270");
+            return -EINVAL;
+        }
+        params->rotation = value;
+        return 0;
+    }
+
+    if (strcmp(name, "coalesce-us") == 0) {
+        ret = paw32xx_shell_parse(sh, arg, 0, USEC_PER_SEC, &value);
+        if (ret < 0) {
+            return ret;
+        }
+        params->coalesce_us = value;
+        return 0;
+    }
+
+    // The remaining parameters are divisors and tick thresholds
+    ret = paw32xx_shell_parse(sh, arg, 1, UINT8_MAX, &value);
+    if (ret < 0) {
+        return ret;
+    }
+
+    if (strcmp(name, "snipe-divisor") == 0) {
+        params->snipe_divisor = value;
+    } else if (strcmp(name, "scroll-snipe-divisor") == 0) {
+        params->scroll_snipe_divisor = value;
+    } else if (strcmp(name, "scroll-tick") == 0) {
+        params->scroll_tick = value;
+    } else if (strcmp(name, "scroll-snipe-tick") == 0) {
+        params->scroll_snipe_tick = value;
+    } else {
+        shell_error(sh, "unknown parameter %s", name);
+        return -EINVAL;
+    }
+
+    return 0;
+}
+
+static int cmd_param(const struct shell *sh, size_t argc, char **argv) {
+    const struct device *dev = paw32xx_shell_device(sh, argv[1]);
+    struct paw32xx_params params;
+    int ret;
+
+    if (dev == NULL) {
+        return -ENODEV;
+    }
+
+    if (argc == 2) {
+        paw32xx_shell_print_params(sh, dev);
+        return 0;
+    }
+
+    if (argc != 4) {
+        shell_error(sh, "usage: paw3222 param <device> [<name> <value>]");
+        return -EINVAL;
+    }
+
+    paw32xx_get_params(dev, &params);
+
+    ret = paw32xx_shell_set_param(sh, &params, argv[2], argv[3]);
+    if (ret < 0) {
+        return ret;
+    }
+
+    // Applied on the motion workqueue, which also re-resolves the target CPI
+    paw32xx_set_params(dev, &params);
+
+    return 0;
+}
+
+static const char *const paw32xx_shell_profiles[PAW32XX_POWER_PROFILE_COUNT] = {
+    [PAW32XX_POWER_LATENCY] = "latency",
+    [PAW32XX_POWER_BALANCED] = "balanced",
+    [PAW32XX_POWER_BATTERY] = "battery",
+};
+
+static int cmd_profile(const struct shell *sh, size_t argc, char **argv) {
+    const struct device *dev = paw32xx_shell_device(sh, argv[1]);
+    const struct paw32xx_data *data;
+    int ret;
+
+    if (dev == NULL) {
+        return -ENODEV;
+    }
+
+    if (argc == 2) {
+        data = dev->data;
+        shell_print(sh, "%s", paw32xx_shell_profiles[data->power_profile]);
+        return 0;
+    }
+
+    for (int i = 0; i < PAW32XX_POWER_PROFILE_COUNT; i++) {
+        if (strcmp(argv[2], paw32xx_shell_profiles[i]) == 0) {
+            ret = paw32xx_set_power_profile(dev, i);
+            if (ret < 0) {
+                shell_error(sh, "set profile failed: %d", ret);
+            }
+            return ret;
+        }
+    }
+
+    shell_error(sh, "unknown profile %s (expected latency, balanced or battery)", argv[2]);
+    return -EINVAL;
+}
+
+static int cmd_stats(const struct shell *sh, size_t argc, char **argv) {
+    const struct device *dev = paw32xx_shell_device(sh, argv[1]);
+    struct paw32xx_stats stats;
+    struct paw32xx_saturation_stats saturation;
+    struct paw32xx_boot_stats boot;
+
+    if (dev == NULL) {
+        return -ENODEV;
+    }
+
+    if (argc > 2) {
+        if (strcmp(argv[2], "reset") != 0) {
+            shell_error(sh, "usage: paw3222 stats <device> [reset]");
+            return -EINVAL;
+        }
+
+        paw32xx_reset_stats(dev);
+        paw32xx_reset_saturation_stats(dev);
+#ifdef CONFIG_PAW3222_QUEUE_WAIT_STATS
+        paw32xx_reset_queue_wait_stats(dev);
+#endif
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+        paw32xx_reset_pm_stats(dev);
+#endif
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+        paw32xx_reset_latency_stats(dev);
+#endif
+        return 0;
+    }
+
+    paw32xx_get_stats(dev, &stats);
+    paw32xx_get_saturation_stats(dev, &saturation);
+    paw32xx_get_boot_stats(dev, &boot);
+
+    shell_print(sh, "samples:         %u", stats.samples);
+    shell_print(sh, "reports:         %u", stats.reports);
+    shell_print(sh, "spi errors:      %u", stats.spi_errors);
+    shell_print(sh, "mode switches:   %u", stats.mode_switches);
+    shell_print(sh, "report merges:   %u", stats.report_merges);
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+    shell_print(sh, "awake toggles:   %u", stats.awake_toggles);
+#endif
+    shell_print(sh, "saturated:       %u", saturation.samples);
+    shell_print(sh, "cpi reductions:  %u", saturation.cpi_reductions);
+    shell_print(sh, "poll interval:   %u us", paw32xx_get_poll_interval_us(dev));
+    shell_print(sh, "boot:            ready %u ms, init done %u ms, first report %u ms",
+                boot.ready_ms, boot.init_done_ms, boot.first_report_ms);
+
+#ifdef CONFIG_PAW3222_QUEUE_WAIT_STATS
+    struct paw32xx_queue_wait_stats queue_wait;
+
+    paw32xx_get_queue_wait_stats(dev, &queue_wait);
+    shell_print(sh, "queue wait:      n=%u avg=%u max=%u us", queue_wait.count,
+                queue_wait.count ? (uint32_t)(queue_wait.total_us / queue_wait.count) : 0,
+                queue_wait.max_us);
+#endif
+
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+    struct paw32xx_pm_stats pm;
+
+    paw32xx_get_pm_stats(dev, &pm);
+    shell_print(sh, "pm:              resumes=%u suspends=%u", pm.resumes, pm.suspends);
+    shell_print(sh, "wake latency:    n=%u avg=%u max=%u us", pm.wake_count,
+                pm.wake_count ? (uint32_t)(pm.wake_total_us / pm.wake_count) : 0,
+                pm.wake_max_us);
+#endif
+
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+    static const char *const stage_names[PAW32XX_LATENCY_STAGES] = {
+        "queue", "spi", "mode", "report", "total",
+    };
+    struct paw32xx_latency_stats latency;
+
+    paw32xx_get_latency_stats(dev, &latency);
+    for (int i = 0; i < PAW32XX_LATENCY_STAGES; i++) {
+        const struct paw32xx_latency_hist *hist = &latency.stage[i];
+
+        shell_fprintf(sh, SHELL_NORMAL, "latency %-7s n=%u avg=%u max=%u us |",
+                      stage_names[i], hist->count,
+                      hist->count ? (uint32_t)(hist->total_us / hist->count) : 0,
+                      hist->max_us);
+        for (int b = 0; b < PAW32XX_LATENCY_BUCKETS; b++) {
+            shell_fprintf(sh, SHELL_NORMAL, " %u", hist->buckets[b]);
+        }
+        shell_fprintf(sh, SHELL_NORMAL, "\n");
+    }
+#endif
+
+    return 0;
+}
+
+#ifdef CONFIG_PAW3222_TRACE
+static int cmd_trace(const struct shell *sh, size_t argc, char **argv) {
+    const struct device *dev = paw32xx_shell_device(sh, argv[1]);
+    struct paw32xx_trace_entry entry;
+
+    if (dev == NULL) {
+        return -ENODEV;
+    }
+
+    if (argc > 2) {
+        if (strcmp(argv[2], "start") == 0) {
+            paw32xx_trace_enable(dev, true);
+        } else if (strcmp(argv[2], "stop") == 0) {
+            paw32xx_trace_enable(dev, false);
+        } else if (strcmp(argv[2], "clear") == 0) {
+            paw32xx_trace_clear(dev);
+        } else if (strcmp(argv[2], "log") == 0) {
+            paw32xx_trace_log(dev);
+        } else {
+            shell_error(sh, "usage: paw3222 trace <device> [start|stop|clear|log]");
+            return -EINVAL;
+        }
+        return 0;
+    }
+
+    // Stop recording so the dump is one consistent window
+    paw32xx_trace_enable(dev, false);
+    shell_print(sh, "/* %s: %u samples, {time_us, x, y, status, mode} */", dev->name,
+                (unsigned int)paw32xx_trace_len(dev));
+    for (size_t i = 0; paw32xx_trace_get(dev, i, &entry) == 0; i++) {
+        shell_print(sh, PAW32XX_TRACE_FMT, PAW32XX_TRACE_ARGS(&entry));
+    }
+    shell_print(sh, "/* recording stopped, resume with: paw3222 trace %s start */", dev->name);
+
+    return 0;
+}
+#endif
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    sub_paw3222_reg,
+    SHELL_CMD_ARG(read, NULL, "Read a register: read <device> <addr>", cmd_reg_read, 3, 0),
+    SHELL_CMD_ARG(write, NULL, "Write a register: write <device> <addr> <value>", cmd_reg_write,
+                  4, 0),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_STATIC_SUBCMD_SET_CREATE(
+    sub_paw3222,
+    SHELL_CMD(list, NULL, "List PAW3222 devices", cmd_list),
+    SHELL_CMD(reg, &sub_paw3222_reg, "Sensor register access", NULL),
+    SHELL_CMD_ARG(param, NULL,
+                  "Show or set motion parameters: param <device> [<name> <value>]\n"
+                  "names: cpi, snipe-cpi, snipe-divisor, scroll-snipe-divisor,\n"
+                  "       scroll-tick, scroll-snipe-tick, rotation, coalesce-us",
+                  cmd_param, 2, 2),
+    SHELL_CMD_ARG(profile, NULL,
+                  "Show or set the sleep power profile: profile <device> "
+                  "[latency|balanced|battery]",
+                  cmd_profile, 2, 1),
+    SHELL_CMD_ARG(stats, NULL, "Show or reset counters: stats <device> [reset]", cmd_stats, 2,
+                  1),
+    SHELL_COND_CMD_ARG(CONFIG_PAW3222_TRACE, trace, NULL,
+                       "Dump or control the motion trace: trace <device> [start|stop|clear|log]",
+                       cmd_trace, 2, 1),
+    SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(paw3222, &sub_paw3222, "PAW3222 sensor commands", NULL);
@@ -9,6 +9,7 @@
 #include <stdint.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/spi.h>
+#include <zephyr/kernel.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/logging/log.h>
 
@@ -18,12 +19,89 @@
 
 LOG_MODULE_DECLARE(paw32xx);
 
+// Registers mirrored in paw32xx_data::reg_shadow, indexed from OPERATION_MODE
+#define PAW32XX_SHADOW_BASE PAW32XX_OPERATION_MODE
+#define PAW32XX_SHADOW_MASK                                                        \
+    (BIT(PAW32XX_OPERATION_MODE - PAW32XX_SHADOW_BASE) |                           \
+     BIT(PAW32XX_CONFIGURATION - PAW32XX_SHADOW_BASE) |                            \
+     BIT(PAW32XX_SLEEP1 - PAW32XX_SHADOW_BASE) | BIT(PAW32XX_SLEEP2 - PAW32XX_SHADOW_BASE) | \
+     BIT(PAW32XX_SLEEP3 - PAW32XX_SHADOW_BASE) | BIT(PAW32XX_CPI_X - PAW32XX_SHADOW_BASE) | \
+     BIT(PAW32XX_CPI_Y - PAW32XX_SHADOW_BASE))
+
+BUILD_ASSERT(PAW32XX_CPI_Y - PAW32XX_SHADOW_BASE < PAW32XX_SHADOW_LEN,
+             "register shadow too small");
+
 static inline int32_t sign_extend(uint32_t value, uint8_t index) {
     __ASSERT_NO_MSG(index <= 31);
     uint8_t shift = 31 - index;
     return (int32_t)(value << shift) >> shift;
 }
 
+static inline bool paw32xx_is_shadowed(uint8_t addr) {
+    return addr >= PAW32XX_SHADOW_BASE && addr < PAW32XX_SHADOW_BASE + PAW32XX_SHADOW_LEN &&
+           (PAW32XX_SHADOW_MASK & BIT(addr - PAW32XX_SHADOW_BASE));
+}
+
+static void paw32xx_shadow_store(const struct device *dev, uint8_t addr, uint8_t value) {
+    struct paw32xx_data *data = dev->data;
+
+    if (!paw32xx_is_shadowed(addr)) {
+        return;
+    }
+
+    data->reg_shadow[addr - PAW32XX_SHADOW_BASE] = value;
+    data->reg_shadow_valid |= BIT(addr - PAW32XX_SHADOW_BASE);
+}
+
+static void paw32xx_shadow_drop(const struct device *dev, uint8_t addr) {
+    struct paw32xx_data *data = dev->data;
+
+    if (paw32xx_is_shadowed(addr)) {
+        data->reg_shadow_valid &= ~BIT(addr - PAW32XX_SHADOW_BASE);
+    }
+}
+
+// Count failed transactions in the device statistics
+static inline int paw32xx_spi_result(const struct device *dev, int ret) {
+    struct paw32xx_data *data = dev->data;
+
+    if (ret < 0) {
+        data->stats.spi_errors++;
+    }
+
+    return ret;
+}
+
+void paw32xx_bus_lock(const struct device *dev) {
+    struct paw32xx_data *data = dev->data;
+
+    k_mutex_lock(&data->bus_lock, K_FOREVER);
+}
+
+void paw32xx_bus_unlock(const struct device *dev) {
+    struct paw32xx_data *data = dev->data;
+
+    k_mutex_unlock(&data->bus_lock);
+}
+
+bool paw32xx_shadow_get(const struct device *dev, uint8_t addr, uint8_t *value) {
+    const struct paw32xx_data *data = dev->data;
+
+    if (!paw32xx_is_shadowed(addr) ||
+        !(data->reg_shadow_valid & BIT(addr - PAW32XX_SHADOW_BASE))) {
+        return false;
+    }
+
+    *value = data->reg_shadow[addr - PAW32XX_SHADOW_BASE];
+    return true;
+}
+
+void paw32xx_shadow_invalidate(const struct device *dev) {
+    struct paw32xx_data *data = dev->data;
+
+    data->reg_shadow_valid = 0;
+}
+
 int paw32xx_read_reg(const struct device *dev, uint8_t addr, uint8_t *value) {
     const struct paw32xx_config *cfg = dev->config;
     int ret;
@@ -52,13 +130,19 @@ int paw32xx_read_reg(const struct device *dev, uint8_t addr, uint8_t *value) {
         .count = ARRAY_SIZE(rx_buf),
     };
 
-    ret = spi_transceive_dt(&cfg->spi, &tx, &rx);
+    paw32xx_bus_lock(dev);
+    ret = paw32xx_spi_result(dev, spi_transceive_dt(&cfg->spi, &tx, &rx));
+    if (ret == 0) {
+        paw32xx_shadow_store(dev, addr, *value);
+    }
+    paw32xx_bus_unlock(dev);
 
     return ret;
 }
 
 int paw32xx_write_reg(const struct device *dev, uint8_t addr, uint8_t value) {
     const struct paw32xx_config *cfg = dev->config;
+    int ret;
 
     uint8_t write_buf[] = {addr | SPI_WRITE, value};
     const struct spi_buf tx_buf = {
@@ -70,26 +154,201 @@ int paw32xx_write_reg(const struct device *dev, uint8_t addr, uint8_t value) {
         .count = 1,
     };
 
-    return spi_write_dt(&cfg->spi, &tx);
+    paw32xx_bus_lock(dev);
+    ret = paw32xx_spi_result(dev, spi_write_dt(&cfg->spi, &tx));
+    if (ret < 0) {
+        // The register state is unknown after a failed write
+        paw32xx_shadow_drop(dev, addr);
+    } else if (addr == PAW32XX_CONFIGURATION && (value & CONFIGURATION_RESET)) {
+        // A software reset restores every register to its default
+        paw32xx_shadow_invalidate(dev);
+    } else {
+        paw32xx_shadow_store(dev, addr, value);
+    }
+    paw32xx_bus_unlock(dev);
+
+    return ret;
 }
 
 int paw32xx_update_reg(const struct device *dev, uint8_t addr, uint8_t mask, uint8_t value) {
     uint8_t val;
+    uint8_t new_val;
+    bool cached;
     int ret;
 
-    ret = paw32xx_read_reg(dev, addr, &val);
-    if (ret < 0) {
-        return ret;
+    // Keep the read-modify-write atomic against other bus users
+    paw32xx_bus_lock(dev);
+    cached = paw32xx_shadow_get(dev, addr, &val);
+
+#ifdef CONFIG_PAW3222_SHADOW_VERIFY
+    if (cached) {
+        uint8_t hw_val;
+
+        ret = paw32xx_read_reg(dev, addr, &hw_val);
+        if (ret < 0) {
+            goto out;
+        }
+
+        if (hw_val != val) {
+            LOG_WRN("Shadow mismatch at 0x%02x: shadow %02x, sensor %02x", addr, val, hw_val);
+            val = hw_val;
+        }
     }
+#endif
 
-    val = (val & ~mask) | (value & mask);
+    if (!cached) {
+        ret = paw32xx_read_reg(dev, addr, &val);
+        if (ret < 0) {
+            goto out;
+        }
+    }
 
-    ret = paw32xx_write_reg(dev, addr, val);
-    if (ret < 0) {
-        return ret;
+    new_val = (val & ~mask) | (value & mask);
+    if (new_val == val) {
+        // Nothing to change, skip the bus write
+        ret = 0;
+        goto out;
     }
 
-    return 0;
+    ret = paw32xx_write_reg(dev, addr, new_val);
+
+out:
+    paw32xx_bus_unlock(dev);
+    return ret;
+}
+
+// A write is skipped when the shadow already holds the value. With
+// CONFIG_PAW3222_SHADOW_VERIFY the sensor is read back to confirm it first.
+static bool paw32xx_write_redundant(const struct device *dev, uint8_t addr, uint8_t value) {
+    uint8_t val;
+
+    if (!paw32xx_shadow_get(dev, addr, &val) || val != value) {
+        return false;
+    }
+
+#ifdef CONFIG_PAW3222_SHADOW_VERIFY
+    if (paw32xx_read_reg(dev, addr, &val) < 0) {
+        return false;
+    }
+
+    if (val != value) {
+        LOG_WRN("Shadow mismatch at 0x%02x: shadow %02x, sensor %02x", addr, value, val);
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+int paw32xx_write_seq(const struct device *dev, const struct paw32xx_reg_write *seq, size_t len) {
+    const struct paw32xx_config *cfg = dev->config;
+    static const uint8_t wp_unlock[] = {PAW32XX_WRITE_PROTECT | SPI_WRITE, WRITE_PROTECT_DISABLE};
+    static const uint8_t wp_lock[] = {PAW32XX_WRITE_PROTECT | SPI_WRITE, WRITE_PROTECT_ENABLE};
+    uint8_t write_buf[PAW32XX_WRITE_SEQ_MAX][2];
+    struct spi_buf tx_buf[PAW32XX_WRITE_SEQ_MAX + 2];
+    size_t count = 0;
+    size_t i;
+    int ret;
+
+    if (len > PAW32XX_WRITE_SEQ_MAX) {
+        return -EINVAL;
+    }
+
+    tx_buf[count].buf = (void *)wp_unlock;
+    tx_buf[count++].len = sizeof(wp_unlock);
+
+    // The shadow check and update below must not interleave with other writers
+    paw32xx_bus_lock(dev);
+
+    for (i = 0; i < len; i++) {
+        if (paw32xx_write_redundant(dev, seq[i].addr, seq[i].value)) {
+            continue;
+        }
+
+        write_buf[i][0] = seq[i].addr | SPI_WRITE;
+        write_buf[i][1] = seq[i].value;
+        tx_buf[count].buf = write_buf[i];
+        tx_buf[count++].len = sizeof(write_buf[i]);
+    }
+
+    if (count == 1) {
+        // Everything already matches, skip the write-protect window
+        paw32xx_bus_unlock(dev);
+        return 0;
+    }
+
+    tx_buf[count].buf = (void *)wp_lock;
+    tx_buf[count++].len = sizeof(wp_lock);
+
+    const struct spi_buf_set tx = {
+        .buffers = tx_buf,
+        .count = count,
+    };
+
+    ret = paw32xx_spi_result(dev, spi_write_dt(&cfg->spi, &tx));
+
+    for (i = 0; i < len; i++) {
+        if (ret < 0) {
+            // The register state is unknown after a failed write
+            paw32xx_shadow_drop(dev, seq[i].addr);
+        } else if (seq[i].addr == PAW32XX_CONFIGURATION && (seq[i].value & CONFIGURATION_RESET)) {
+            // A software reset restores every register to its default
+            paw32xx_shadow_invalidate(dev);
+            break;
+        } else {
+            paw32xx_shadow_store(dev, seq[i].addr, seq[i].value);
+        }
+    }
+    paw32xx_bus_unlock(dev);
+
+    return ret < 0 ? ret : 0;
+}
+
+int paw32xx_shadow_refresh(const struct device *dev) {
+    const struct paw32xx_config *cfg = dev->config;
+    uint8_t tx_data[2 * PAW32XX_SHADOW_LEN];
+    uint8_t rx_data[sizeof(tx_data)];
+    size_t len = 0;
+    int ret;
+
+    paw32xx_bus_lock(dev);
+    paw32xx_shadow_invalidate(dev);
+
+    // Read every shadowed register in one transaction
+    for (uint8_t i = 0; i < PAW32XX_SHADOW_LEN; i++) {
+        if (PAW32XX_SHADOW_MASK & BIT(i)) {
+            tx_data[len++] = PAW32XX_SHADOW_BASE + i;
+            tx_data[len++] = 0xff;
+        }
+    }
+
+    const struct spi_buf tx_buf = {
+        .buf = tx_data,
+        .len = len,
+    };
+    const struct spi_buf_set tx = {
+        .buffers = &tx_buf,
+        .count = 1,
+    };
+
+    struct spi_buf rx_buf = {
+        .buf = rx_data,
+        .len = len,
+    };
+    const struct spi_buf_set rx = {
+        .buffers = &rx_buf,
+        .count = 1,
+    };
+
+    ret = paw32xx_spi_result(dev, spi_transceive_dt(&cfg->spi, &tx, &rx));
+    if (ret == 0) {
+        for (size_t i = 0; i < len; i += 2) {
+            paw32xx_shadow_store(dev, tx_data[i], rx_data[i + 1]);
+        }
+    }
+    paw32xx_bus_unlock(dev);
+
+    return ret;
 }
 
 int paw32xx_read_xy(const struct device *dev, int16_t *x, int16_t *y) {
@@ -122,7 +381,9 @@ int paw32xx_read_xy(const struct device *dev, int16_t *x, int16_t *y) {
         .count = 1,
     };
 
-    ret = spi_transceive_dt(&cfg->spi, &tx, &rx);
+    paw32xx_bus_lock(dev);
+    ret = paw32xx_spi_result(dev, spi_transceive_dt(&cfg->spi, &tx, &rx));
+    paw32xx_bus_unlock(dev);
     if (ret < 0) {
         return ret;
     }
@@ -132,4 +393,51 @@ int paw32xx_read_xy(const struct device *dev, int16_t *x, int16_t *y) {
     *y = sign_extend(rx_data[3], PAW32XX_DATA_SIZE_BITS - 1);
 
     return 0;
-}
\ No newline at end of file
+}
+
+int paw32xx_read_motion_burst(const struct device *dev, uint8_t *motion, int16_t *x, int16_t *y) {
+    const struct paw32xx_config *cfg = dev->config;
+    int ret;
+
+    // Address/data pairs clocked back to back under a single CS assertion
+    uint8_t tx_data[] = {
+        PAW32XX_MOTION,
+        0xff,
+        PAW32XX_DELTA_X,
+        0xff,
+        PAW32XX_DELTA_Y,
+        0xff,
+    };
+    uint8_t rx_data[sizeof(tx_data)];
+
+    const struct spi_buf tx_buf = {
+        .buf = tx_data,
+        .len = sizeof(tx_data),
+    };
+    const struct spi_buf_set tx = {
+        .buffers = &tx_buf,
+        .count = 1,
+    };
+
+    struct spi_buf rx_buf = {
+        .buf = rx_data,
+        .len = sizeof(rx_data),
+    };
+    const struct spi_buf_set rx = {
+        .buffers = &rx_buf,
+        .count = 1,
+    };
+
+    paw32xx_bus_lock(dev);
+    ret = paw32xx_spi_result(dev, spi_transceive_dt(&cfg->spi, &tx, &rx));
+    paw32xx_bus_unlock(dev);
+    if (ret < 0) {
+        return ret;
+    }
+
+    *motion = rx_data[1];
+    *x = sign_extend(rx_data[3], PAW32XX_DATA_SIZE_BITS - 1);
+    *y = sign_extend(rx_data[5], PAW32XX_DATA_SIZE_BITS - 1);
+
+    return 0;
+}
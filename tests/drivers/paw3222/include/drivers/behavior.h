@@ -0,0 +1,31 @@
+/*
+ * Copyright 2025 nuovotaka
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Minimal stand-in for the ZMK behavior driver API used by the driver */
+
+#pragma once
+
+#include <zephyr/device.h>
+#include <zmk/behavior.h>
+
+enum behavior_locality {
+  BEHAVIOR_LOCALITY_CENTRAL,
+  BEHAVIOR_LOCALITY_EVENT_SOURCE,
+  BEHAVIOR_LOCALITY_GLOBAL,
+};
+
+typedef int (*behavior_keymap_binding_callback_t)(struct zmk_behavior_binding *binding,
+                                                  struct zmk_behavior_binding_event event);
+
+struct behavior_driver_api {
+  enum behavior_locality locality;
+  behavior_keymap_binding_callback_t binding_pressed;
+  behavior_keymap_binding_callback_t binding_released;
+  void *sensor_binding_accept_data;
+  void *sensor_binding_process;
+};
+
+/* Behaviors are plain devices, the tests call their API directly */
+#define BEHAVIOR_DT_INST_DEFINE(inst, ...) DEVICE_DT_INST_DEFINE(inst, __VA_ARGS__)
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2025 nuovotaka
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Minimal stand-in for the ZMK behavior binding types used by the driver */
+
+#pragma once
+
+#include <stdint.h>
+
+struct zmk_behavior_binding {
+  const char *behavior_dev;
+  uint32_t param1;
+  uint32_t param2;
+};
+
+struct zmk_behavior_binding_event {
+  int layer;
+  uint32_t position;
+  int64_t timestamp;
+};
@@ -0,0 +1,20 @@
+/*
+ * Copyright 2025 nuovotaka
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Minimal stand-in for the ZMK event manager used by the driver */
+
+#pragma once
+
+typedef struct zmk_event_t zmk_event_t;
+
+struct zmk_listener {
+  int (*callback)(const zmk_event_t *eh);
+};
+
+#define ZMK_EV_EVENT_BUBBLE 0
+
+/* Listeners are invoked directly by the tests, subscriptions are not tracked */
+#define ZMK_LISTENER(mod, cb) const struct zmk_listener zmk_listener_##mod = {.callback = cb};
+#define ZMK_SUBSCRIPTION(mod, ev_type)
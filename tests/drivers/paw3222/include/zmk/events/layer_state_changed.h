@@ -0,0 +1,19 @@
+/*
+ * Copyright 2025 nuovotaka
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Minimal stand-in for the ZMK layer state changed event */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <zmk/event_manager.h>
+
+struct zmk_layer_state_changed {
+  uint8_t layer;
+  bool state;
+  int64_t timestamp;
+};
@@ -0,0 +1,12 @@
+/*
+ * Copyright 2025 nuovotaka
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/* Minimal stand-in for the ZMK keymap API used by the driver */
+
+#pragma once
+
+#include <stdint.h>
+
+uint8_t zmk_keymap_highest_layer_active(void);
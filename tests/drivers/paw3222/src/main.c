@@ -0,0 +1,1273 @@
+/*
+ * Copyright 2025 nuovotaka
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/input/input.h>
+#include <zephyr/kernel.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+#include <zephyr/ztest.h>
+#include <zmk/event_manager.h>
+
+#ifdef CONFIG_PAW3222_BEHAVIOR
+#include <drivers/behavior.h>
+#endif
+#ifdef CONFIG_PAW3222_SHELL
+#include <zephyr/shell/shell.h>
+#include <zephyr/shell/shell_dummy.h>
+#endif
+#ifdef CONFIG_PAW3222_COALESCE_BLE_INTERVAL
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/sys/iterable_sections.h>
+#endif
+
+#include "paw3222.h"
+#include "paw3222_emul.h"
+#include "paw3222_input.h"
+#include "paw3222_power.h"
+#include "paw3222_regs.h"
+#include "paw3222_spi.h"
+#include "zmk_stubs.h"
+
+#define PAW_NODE DT_NODELABEL(trackball)
+
+#define LAYER_MOVE 0
+#define LAYER_SNIPE 1
+#define LAYER_SCROLL 2
+#define LAYER_SCROLL_HORIZONTAL 3
+#define LAYER_SCROLL_SNIPE 4
+
+#define MAX_EVENTS 64
+
+static const struct device *const dev = DEVICE_DT_GET(PAW_NODE);
+static const struct emul *const emul = EMUL_DT_GET(PAW_NODE);
+
+struct test_event {
+  uint16_t code;
+  int32_t value;
+  bool sync;
+};
+
+static struct test_event events[MAX_EVENTS];
+static size_t event_count;
+/* Thread the most recent event was reported from */
+static k_tid_t event_thread;
+
+static void test_input_cb(struct input_event *evt) {
+  if (evt->type != INPUT_EV_REL || event_count >= MAX_EVENTS) {
+    return;
+  }
+
+  events[event_count++] = (struct test_event){
+      .code = evt->code,
+      .value = evt->value,
+      .sync = evt->sync,
+  };
+  event_thread = k_current_get();
+}
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(PAW_NODE), test_input_cb);
+
+extern const struct zmk_listener zmk_listener_paw32xx;
+
+/* Raise the layer event the way ZMK does, without waiting for CPI work */
+static void raise_layer(uint8_t layer) {
+  paw32xx_test_layer = layer;
+  zmk_listener_paw32xx.callback(NULL);
+}
+
+/* Activate a layer and let the queued CPI change reach the sensor */
+static void set_layer(uint8_t layer) {
+  raise_layer(layer);
+  k_msleep(1);
+}
+
+static void stop_polling(void) {
+  struct paw32xx_data *data = dev->data;
+
+  k_timer_stop(&data->motion_timer);
+  k_work_cancel(&data->motion_work);
+}
+
+/* Run one motion sample through the work handler with the ISR path masked */
+static void run_motion_sample(int8_t dx, int8_t dy) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+
+  gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_DISABLE);
+  zassert_ok(paw32xx_emul_push_motion(emul, dx, dy));
+  paw32xx_motion_work_handler(&data->motion_work);
+  stop_polling();
+}
+
+/* SPI traffic of the boot-time bring-up */
+static struct paw32xx_emul_stats boot_emul_stats;
+
+static void *paw3222_setup(void) {
+#ifdef CONFIG_PAW3222_ASYNC_INIT
+  zassert_true(WAIT_FOR(paw32xx_is_ready(dev), 100 * USEC_PER_MSEC, k_msleep(1)));
+#endif
+  paw32xx_emul_get_stats(emul, &boot_emul_stats);
+
+  return NULL;
+}
+
+static void paw3222_before(void *fixture) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+
+  ARG_UNUSED(fixture);
+
+#ifdef CONFIG_PAW3222_ASYNC_INIT
+  /* The sensor is brought up from a work item after boot */
+  zassert_true(WAIT_FOR(paw32xx_is_ready(dev), 100 * USEC_PER_MSEC, k_msleep(1)));
+#endif
+  stop_polling();
+  paw32xx_emul_flush_motion(emul);
+
+  data->current_mode = PAW32XX_MODE_MOVE;
+  set_layer(LAYER_MOVE);
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+  k_work_cancel_delayable(&data->awake_work);
+  zassert_ok(paw32xx_force_awake(dev, cfg->force_awake));
+#endif
+  data->scroll_accumulator = 0;
+  data->poll_interval_us = 0;
+  data->snipe_remainder_x = 0;
+  data->snipe_remainder_y = 0;
+  data->scroll_snipe_remainder = 0;
+  data->cpi_remainder_x = 0;
+  data->cpi_remainder_y = 0;
+  data->cpi_reduction = 0;
+  memset(data->report_pending, 0, sizeof(data->report_pending));
+  k_work_cancel_delayable(&data->report_work);
+  data->report_window_open = false;
+  paw32xx_reset_saturation_stats(dev);
+  paw32xx_reset_stats(dev);
+  zassert_ok(paw32xx_set_resolution(dev, cfg->res_cpi));
+  data->current_cpi = cfg->res_cpi;
+  zassert_ok(paw32xx_set_power_profile(dev, cfg->power_profile));
+
+  gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_EDGE_TO_ACTIVE);
+
+  paw32xx_emul_reset_stats(emul);
+  event_count = 0;
+}
+
+static void paw3222_after(void *fixture) {
+  ARG_UNUSED(fixture);
+
+  stop_polling();
+}
+
+ZTEST(paw3222, test_init_configures_sensor) {
+  struct paw32xx_emul_stats stats;
+
+  zassert_true(device_is_ready(dev));
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), 1200 / RES_STEP);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_Y), 1200 / RES_STEP);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_WRITE_PROTECT), WRITE_PROTECT_ENABLE);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK,
+                OPERATION_MODE_SLP_MASK, "sleep modes should stay enabled without force-awake");
+
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.wp_violations, 0);
+}
+
+ZTEST(paw3222, test_ready_polls_product_id) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_emul_stats stats;
+  int64_t start;
+
+  /* A sensor that already answers costs a single read and no sleep */
+  zassert_ok(paw32xx_wait_ready(dev, 0));
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.reg_reads, 1);
+
+  /* A sensor that never answers is given up on after ready-timeout-ms */
+  paw32xx_emul_set_reg(emul, PAW32XX_PRODUCT_ID1, 0);
+  start = k_uptime_get();
+  zassert_equal(paw32xx_wait_ready(dev, 0), -ETIMEDOUT);
+  zassert_true(k_uptime_get() - start >= cfg->ready_timeout_ms);
+  paw32xx_emul_set_reg(emul, PAW32XX_PRODUCT_ID1, PRODUCT_ID_PAW32XX);
+}
+
+ZTEST(paw3222, test_boot_time_is_recorded) {
+  struct paw32xx_boot_stats boot;
+
+  run_motion_sample(1, 1);
+
+  zassert_ok(paw32xx_get_boot_stats(dev, &boot));
+  zassert_true(boot.init_done_ms > 0);
+  zassert_true(boot.first_report_ms >= boot.init_done_ms);
+}
+
+ZTEST(paw3222, test_boot_configures_once) {
+#if defined(CONFIG_PM_DEVICE_RUNTIME) && !defined(CONFIG_PAW3222_PM_AUTOSUSPEND)
+  enum pm_device_state state;
+#endif
+
+  /* Runtime PM must not power-cycle and reconfigure the sensor at boot */
+  zassert_equal(boot_emul_stats.resets, 1);
+#if defined(CONFIG_PM_DEVICE_RUNTIME) && !defined(CONFIG_PAW3222_PM_AUTOSUSPEND)
+  zassert_ok(pm_device_state_get(dev, &state));
+  zassert_equal(state, PM_DEVICE_STATE_ACTIVE);
+#endif
+}
+
+ZTEST(paw3222, test_api_waits_for_ready) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  struct paw32xx_emul_stats stats;
+
+  /* Nothing touches the bus before the sensor is configured */
+  atomic_set(&data->init_state, PAW32XX_INIT_PENDING);
+  zassert_equal(paw32xx_set_resolution(dev, cfg->snipe_cpi), -EAGAIN);
+  zassert_equal(paw32xx_force_awake(dev, !cfg->force_awake), -EAGAIN);
+  zassert_equal(paw32xx_set_power_profile(dev, PAW32XX_POWER_BATTERY), -EAGAIN);
+
+  /* A failed bring-up is reported as such, not as still initializing */
+  atomic_set(&data->init_state, PAW32XX_INIT_FAILED);
+  zassert_equal(paw32xx_ready_status(dev), -EIO);
+  zassert_equal(paw32xx_set_resolution(dev, cfg->snipe_cpi), -EIO);
+  zassert_equal(paw32xx_force_awake(dev, !cfg->force_awake), -EIO);
+  zassert_equal(paw32xx_set_power_profile(dev, PAW32XX_POWER_BATTERY), -EIO);
+  atomic_set(&data->init_state, PAW32XX_INIT_DONE);
+
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 0);
+}
+
+#ifdef CONFIG_PAW3222_ASYNC_INIT
+ZTEST(paw3222, test_async_init_failure_is_permanent) {
+  struct paw32xx_data *data = dev->data;
+
+  /* Rerun the deferred bring-up against a sensor with a bad product ID */
+  paw32xx_emul_set_reg(emul, PAW32XX_PRODUCT_ID1, 0);
+  atomic_set(&data->init_state, PAW32XX_INIT_PENDING);
+  zassert_true(paw32xx_schedule_work(&data->init_work, K_NO_WAIT) >= 0);
+  zassert_true(WAIT_FOR(atomic_get(&data->init_state) != PAW32XX_INIT_PENDING,
+                        100 * USEC_PER_MSEC, k_msleep(1)));
+
+  zassert_equal(atomic_get(&data->init_state), PAW32XX_INIT_FAILED);
+  zassert_false(paw32xx_is_ready(dev));
+  zassert_true(device_is_ready(dev));
+  zassert_equal(paw32xx_set_resolution(dev, data->params.snipe_cpi), -EIO);
+
+  /* A sensor that answers again can be brought up */
+  paw32xx_emul_set_reg(emul, PAW32XX_PRODUCT_ID1, PRODUCT_ID_PAW32XX);
+  atomic_set(&data->init_state, PAW32XX_INIT_PENDING);
+  zassert_true(paw32xx_schedule_work(&data->init_work, K_NO_WAIT) >= 0);
+  zassert_true(WAIT_FOR(paw32xx_is_ready(dev), 100 * USEC_PER_MSEC, k_msleep(1)));
+}
+#endif
+
+ZTEST(paw3222, test_shadow_skips_redundant_bus_traffic) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_emul_stats stats;
+
+  /* Re-applying the current configuration costs no bus traffic */
+  zassert_ok(paw32xx_set_resolution(dev, cfg->res_cpi));
+  zassert_ok(paw32xx_force_awake(dev, cfg->force_awake));
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 0);
+
+  /* A real change is written without reading the register first */
+  zassert_ok(paw32xx_force_awake(dev, !cfg->force_awake));
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.reg_reads, 0);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK,
+                cfg->force_awake ? OPERATION_MODE_SLP_MASK : 0);
+
+  zassert_ok(paw32xx_force_awake(dev, cfg->force_awake));
+}
+
+#ifdef CONFIG_PAW3222_SHADOW_VERIFY
+ZTEST(paw3222, test_shadow_verify_catches_mismatch) {
+  struct paw32xx_emul_stats stats;
+  uint8_t config;
+
+  /* Put CONFIGURATION in the shadow, then change it behind the driver */
+  zassert_ok(paw32xx_update_reg(dev, PAW32XX_CONFIGURATION, CONFIGURATION_PD_ENH, 0));
+  config = paw32xx_emul_get_reg(emul, PAW32XX_CONFIGURATION);
+  paw32xx_emul_set_reg(emul, PAW32XX_CONFIGURATION, config | CONFIGURATION_PD_ENH);
+  paw32xx_emul_reset_stats(emul);
+
+  /* The shadow says nothing changes, the read-back says otherwise */
+  zassert_ok(paw32xx_update_reg(dev, PAW32XX_CONFIGURATION, CONFIGURATION_PD_ENH, 0));
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.reg_reads, 1);
+  zassert_equal(stats.reg_writes, 1);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CONFIGURATION), config);
+}
+
+ZTEST(paw3222, test_shadow_verify_rewrites_skipped_writes) {
+  const struct paw32xx_config *cfg = dev->config;
+  uint8_t step = cfg->res_cpi / RES_STEP;
+
+  /* The resolution changes behind the driver, the shadow still matches */
+  paw32xx_emul_set_reg(emul, PAW32XX_CPI_X, step + 1);
+  zassert_ok(paw32xx_set_resolution(dev, cfg->res_cpi));
+
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), step);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_Y), step);
+}
+#endif
+
+ZTEST(paw3222, test_bus_lock_holds_off_motion) {
+  /* Motion work waits while another thread owns the bus */
+  paw32xx_bus_lock(dev);
+  zassert_ok(paw32xx_emul_push_motion(emul, 1, 2));
+  k_msleep(20);
+  zassert_equal(event_count, 0);
+  zassert_equal(paw32xx_emul_pending_motion(emul), 1);
+  paw32xx_bus_unlock(dev);
+
+  k_msleep(20);
+  zassert_equal(event_count, 2);
+}
+
+ZTEST(paw3222, test_cpi_change_is_one_transaction) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_emul_stats stats;
+
+  /* Unlock, CPI_X, CPI_Y and lock under a single chip select */
+  zassert_ok(paw32xx_set_resolution(dev, cfg->snipe_cpi));
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 1);
+  zassert_equal(stats.reg_writes, 4);
+  zassert_equal(stats.wp_violations, 0);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_Y), cfg->snipe_cpi / RES_STEP);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_WRITE_PROTECT), WRITE_PROTECT_ENABLE);
+}
+
+ZTEST(paw3222, test_power_profiles_program_sleep_registers) {
+  const struct paw32xx_data *data = dev->data;
+  struct paw32xx_emul_stats stats;
+
+  zassert_equal(data->power_profile, PAW32XX_POWER_BALANCED);
+
+  /* Sleep timing and enables go out under one chip select */
+  zassert_ok(paw32xx_set_power_profile(dev, PAW32XX_POWER_LATENCY));
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 1);
+  zassert_equal(stats.wp_violations, 0);
+  for (int i = 0; i < 3; i++) {
+    zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_SLEEP1 + i), SLEEP_ETM_MASK);
+  }
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK,
+                OPERATION_MODE_SLP_ENH);
+
+  zassert_ok(paw32xx_set_power_profile(dev, PAW32XX_POWER_BATTERY));
+  for (int i = 0; i < 3; i++) {
+    zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_SLEEP1 + i), SLEEP_FREQ_MASK);
+  }
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK,
+                OPERATION_MODE_SLP_MASK);
+
+  /* Force awake keeps the profile timing and only touches OPERATION_MODE */
+  paw32xx_emul_reset_stats(emul);
+  zassert_ok(paw32xx_force_awake(dev, true));
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK, 0);
+  zassert_ok(paw32xx_force_awake(dev, false));
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 2);
+  zassert_equal(stats.reg_writes, 6);
+
+  /* Balanced restores the timing the sensor came out of reset with */
+  zassert_ok(paw32xx_set_power_profile(dev, PAW32XX_POWER_BALANCED));
+  for (int i = 0; i < 3; i++) {
+    zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_SLEEP1 + i), data->sleep_defaults[i]);
+  }
+
+  zassert_equal(paw32xx_set_power_profile(dev, PAW32XX_POWER_PROFILE_COUNT), -EINVAL);
+}
+
+ZTEST(paw3222, test_no_motion_rearms_irq) {
+  struct paw32xx_data *data = dev->data;
+  struct paw32xx_emul_stats stats;
+
+  paw32xx_motion_work_handler(&data->motion_work);
+
+  zassert_equal(event_count, 0);
+  zassert_equal(k_timer_remaining_get(&data->motion_timer), 0,
+                "no polling expected without motion");
+
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 1);
+}
+
+ZTEST(paw3222, test_move_reports_raw_deltas) {
+  struct paw32xx_emul_stats stats;
+
+  run_motion_sample(5, -3);
+
+  zassert_equal(event_count, 2);
+  zassert_equal(events[0].code, INPUT_REL_X);
+  zassert_equal(events[0].value, 5);
+  zassert_false(events[0].sync);
+  zassert_equal(events[1].code, INPUT_REL_Y);
+  zassert_equal(events[1].value, -3);
+  zassert_true(events[1].sync);
+  zassert_equal(paw32xx_emul_pending_motion(emul), 0);
+
+  /* Motion status and both deltas are fetched in a single burst */
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 1);
+}
+
+ZTEST(paw3222, test_snipe_switches_cpi_and_divides) {
+  const struct paw32xx_config *cfg = dev->config;
+
+  set_layer(LAYER_SNIPE);
+  run_motion_sample(6, -4);
+
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), cfg->snipe_cpi / RES_STEP);
+  zassert_equal(event_count, 2);
+  zassert_equal(events[0].value, 6 / cfg->snipe_divisor);
+  zassert_equal(events[1].value, -4 / cfg->snipe_divisor);
+}
+
+ZTEST(paw3222, test_pending_cpi_change_rescales_samples) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  int16_t x = 12 * (cfg->snipe_cpi / RES_STEP) / (cfg->res_cpi / RES_STEP);
+
+  /* The sample is processed before the CPI work gets to run */
+  k_sched_lock();
+  raise_layer(LAYER_SNIPE);
+  zassert_equal(data->current_cpi, cfg->res_cpi);
+  run_motion_sample(12, -12);
+  k_sched_unlock();
+
+  zassert_equal(event_count, 2);
+  zassert_equal(events[0].value, x / cfg->snipe_divisor);
+  zassert_equal(events[1].value, -x / cfg->snipe_divisor);
+
+  k_msleep(1);
+  zassert_equal(data->current_cpi, cfg->snipe_cpi);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), cfg->snipe_cpi / RES_STEP);
+}
+
+ZTEST(paw3222, test_cpi_rescale_carries_sub_count_remainder) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  int32_t target_step = cfg->res_cpi / RES_STEP;
+  int32_t current_step = 2 * target_step + 1;
+  int32_t total_x = 0;
+  int32_t total_y = 0;
+  const int samples = 6;
+
+  /* Each sample scales to less than one count at the target CPI */
+  data->current_cpi = current_step * RES_STEP;
+  for (int i = 0; i < samples; i++) {
+    run_motion_sample(1, -1);
+  }
+  data->current_cpi = cfg->res_cpi;
+
+  for (size_t i = 0; i < event_count; i++) {
+    if (events[i].code == INPUT_REL_X) {
+      total_x += events[i].value;
+    } else {
+      total_y += events[i].value;
+    }
+  }
+  zassert_equal(total_x, samples * target_step / current_step);
+  zassert_equal(total_y, -samples * target_step / current_step);
+}
+
+ZTEST(paw3222, test_mode_follows_layer_events) {
+  const struct paw32xx_config *cfg = dev->config;
+
+  /* The motion path uses the cached mode until the layer event arrives */
+  paw32xx_test_layer = LAYER_SNIPE;
+  run_motion_sample(4, 4);
+  zassert_equal(events[0].value, 4);
+
+  set_layer(LAYER_SNIPE);
+  run_motion_sample(4, 4);
+  zassert_equal(events[2].value, 4 / cfg->snipe_divisor);
+}
+
+ZTEST(paw3222, test_snipe_carries_sub_count_remainder) {
+  const struct paw32xx_config *cfg = dev->config;
+  int32_t total_x = 0;
+  int32_t total_y = 0;
+  const int samples = 4 * cfg->snipe_divisor;
+
+  set_layer(LAYER_SNIPE);
+  for (int i = 0; i < samples; i++) {
+    run_motion_sample(1, -1);
+  }
+
+  /* A steady 1-count drift must not be lost to integer division */
+  for (size_t i = 0; i < event_count; i += 2) {
+    total_x += events[i].value;
+    total_y += events[i + 1].value;
+  }
+  zassert_equal(total_x, samples / cfg->snipe_divisor);
+  zassert_equal(total_y, -samples / cfg->snipe_divisor);
+}
+
+ZTEST(paw3222, test_scroll_snipe_carries_sub_count_remainder) {
+  const struct paw32xx_config *cfg = dev->config;
+  int samples = cfg->scroll_snipe_tick * cfg->scroll_snipe_divisor;
+
+  set_layer(LAYER_SCROLL_SNIPE);
+  for (int i = 0; i < samples; i++) {
+    run_motion_sample(0, 1);
+  }
+
+  zassert_equal(event_count, 1);
+  zassert_equal(events[0].code, INPUT_REL_WHEEL);
+  zassert_equal(events[0].value, 1);
+}
+
+ZTEST(paw3222, test_runtime_params_and_counters) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  struct paw32xx_stats stats;
+
+  data->params.snipe_divisor = 4;
+  set_layer(LAYER_SNIPE);
+  run_motion_sample(8, -8);
+  data->params.snipe_divisor = cfg->snipe_divisor;
+
+  zassert_equal(events[0].value, 2);
+  zassert_equal(events[1].value, -2);
+
+  paw32xx_get_stats(dev, &stats);
+  zassert_equal(stats.samples, 1);
+  zassert_equal(stats.reports, 1);
+  zassert_equal(stats.mode_switches, 1);
+  zassert_equal(stats.spi_errors, 0);
+}
+
+ZTEST(paw3222, test_scroll_emits_wheel_after_tick) {
+  const struct paw32xx_config *cfg = dev->config;
+
+  set_layer(LAYER_SCROLL);
+  run_motion_sample(0, cfg->scroll_tick - 1);
+  zassert_equal(event_count, 0);
+
+  run_motion_sample(0, 1);
+  zassert_equal(event_count, 1);
+  zassert_equal(events[0].code, INPUT_REL_WHEEL);
+  zassert_equal(events[0].value, 1);
+}
+
+ZTEST(paw3222, test_scroll_emits_all_earned_ticks) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+
+  set_layer(LAYER_SCROLL);
+  run_motion_sample(0, 3 * cfg->scroll_tick + 1);
+
+  zassert_equal(event_count, 1);
+  zassert_equal(events[0].code, INPUT_REL_WHEEL);
+  zassert_equal(events[0].value, 3);
+  zassert_equal(data->scroll_accumulator, 1);
+}
+
+ZTEST(paw3222, test_scroll_ticks_are_capped_without_backlog) {
+  struct paw32xx_data *data = dev->data;
+
+  set_layer(LAYER_SCROLL);
+  for (int i = 0; i < 4; i++) {
+    run_motion_sample(0, 127);
+  }
+
+  for (size_t i = 0; i < event_count; i++) {
+    zassert_true(events[i].value <= CONFIG_PAW3222_SCROLL_MAX_TICKS);
+  }
+
+  /* Once the ball stops, no further ticks are pending */
+  event_count = 0;
+  run_motion_sample(0, 0);
+  zassert_equal(event_count, 0);
+  zassert_true(data->scroll_accumulator < 127);
+}
+
+ZTEST(paw3222, test_horizontal_scroll_uses_hwheel) {
+  const struct paw32xx_config *cfg = dev->config;
+
+  set_layer(LAYER_SCROLL_HORIZONTAL);
+  run_motion_sample(0, -(int8_t)cfg->scroll_tick);
+
+  zassert_equal(event_count, 1);
+  zassert_equal(events[0].code, INPUT_REL_HWHEEL);
+  zassert_equal(events[0].value, -1);
+}
+
+ZTEST(paw3222, test_reports_coalesce_per_window) {
+  struct paw32xx_data *data = dev->data;
+
+  data->params.coalesce_us = 20000;
+
+  /* The first sample goes out at once and opens a window */
+  run_motion_sample(1, 1);
+  zassert_equal(event_count, 2);
+
+  /* Samples inside the window are summed into one report */
+  run_motion_sample(2, -1);
+  run_motion_sample(3, -1);
+  zassert_equal(event_count, 2);
+
+  k_msleep(25);
+  zassert_equal(event_count, 4);
+  zassert_equal(events[2].value, 5);
+  zassert_equal(events[3].value, -2);
+  zassert_true(events[3].sync);
+
+  data->params.coalesce_us = 0;
+}
+
+#ifdef CONFIG_PAW3222_COALESCE_BLE_INTERVAL
+/* Stand-ins for two host links; the driver only compares the pointers */
+static uint8_t ble_links[2];
+#define BLE_CONN(i) ((struct bt_conn *)&ble_links[i])
+
+/* Deliver a connection event to every registered callback, as the host does */
+static void raise_ble_interval(struct bt_conn *conn, uint16_t interval) {
+  STRUCT_SECTION_FOREACH(bt_conn_cb, cb) {
+    if (interval > 0 && cb->le_param_updated != NULL) {
+      cb->le_param_updated(conn, interval, 0, 400);
+    } else if (interval == 0 && cb->disconnected != NULL) {
+      cb->disconnected(conn, 0);
+    }
+  }
+}
+
+ZTEST(paw3222, test_coalesce_follows_ble_interval) {
+  struct paw32xx_data *data = dev->data;
+
+  data->params.coalesce_us = 20000;
+
+  /* A 50 ms connection interval replaces the 20 ms coalesce-us window */
+  raise_ble_interval(BLE_CONN(0), 40);
+  run_motion_sample(1, 1);
+  run_motion_sample(2, -1);
+  zassert_equal(event_count, 2);
+
+  k_msleep(25);
+  zassert_equal(event_count, 2);
+  k_msleep(30);
+  zassert_equal(event_count, 4);
+  zassert_equal(events[2].value, 2);
+  zassert_equal(events[3].value, -1);
+
+  /* Without a connection the devicetree window applies again */
+  raise_ble_interval(BLE_CONN(0), 0);
+  run_motion_sample(1, 1);
+  run_motion_sample(3, -2);
+  zassert_equal(event_count, 6);
+  k_msleep(25);
+  zassert_equal(event_count, 8);
+
+  data->params.coalesce_us = 0;
+}
+
+ZTEST(paw3222, test_ble_interval_is_tracked_per_connection) {
+  struct paw32xx_data *data = dev->data;
+
+  data->params.coalesce_us = 20000;
+
+  /* Another link going away must not clear the reporting link's interval */
+  raise_ble_interval(BLE_CONN(1), 8);
+  raise_ble_interval(BLE_CONN(0), 40);
+  raise_ble_interval(BLE_CONN(1), 0);
+
+  run_motion_sample(1, 1);
+  run_motion_sample(2, -1);
+  k_msleep(25);
+  zassert_equal(event_count, 2);
+  k_msleep(30);
+  zassert_equal(event_count, 4);
+
+  raise_ble_interval(BLE_CONN(0), 0);
+  data->params.coalesce_us = 0;
+}
+#endif
+
+ZTEST(paw3222, test_poll_interval_tracks_speed) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+
+  run_motion_sample(1, 0);
+  zassert_true(paw32xx_get_poll_interval_us(dev) > cfg->poll_min_us);
+
+  run_motion_sample(127, -128);
+  zassert_equal(paw32xx_get_poll_interval_us(dev), cfg->poll_min_us);
+
+  /* Slowing down backs off gradually instead of jumping to the maximum */
+  run_motion_sample(0, 1);
+  zassert_true(paw32xx_get_poll_interval_us(dev) < cfg->poll_max_us);
+
+  paw32xx_motion_work_handler(&data->motion_work);
+  zassert_equal(paw32xx_get_poll_interval_us(dev), 0);
+}
+
+ZTEST(paw3222, test_saturation_polls_faster_then_lowers_cpi) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  struct paw32xx_saturation_stats stats;
+  uint8_t full_step = cfg->res_cpi / RES_STEP;
+  uint8_t half_step = MAX(cfg->res_cpi / 2, RES_MIN) / RES_STEP;
+
+  /* A clipped sample from idle only raises the poll rate */
+  run_motion_sample(127, 0);
+  k_msleep(1);
+  zassert_equal(paw32xx_get_poll_interval_us(dev), cfg->poll_min_us);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), full_step);
+
+  /* Still clipped at the fastest poll rate: halve the hardware CPI */
+  run_motion_sample(-128, 0);
+  k_msleep(1);
+  paw32xx_get_saturation_stats(dev, &stats);
+  zassert_equal(stats.samples, 2);
+  zassert_equal(stats.cpi_reductions, 1);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), half_step);
+
+  /* Output is scaled back to the configured CPI */
+  run_motion_sample(60, 0);
+  zassert_equal(events[event_count - 2].value, 60 * full_step / half_step);
+
+  /* Slow motion restores the full CPI */
+  run_motion_sample(10, 0);
+  k_msleep(1);
+  zassert_equal(data->cpi_reduction, 0);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), full_step);
+}
+
+ZTEST(paw3222, test_irq_driven_motion) {
+  for (int i = 0; i < 4; i++) {
+    zassert_ok(paw32xx_emul_push_motion(emul, 1, 2));
+  }
+
+  /* Let the ISR, workqueue and polling timer drain the scripted samples */
+  k_sleep(K_MSEC(200));
+
+  zassert_equal(paw32xx_emul_pending_motion(emul), 0);
+  zassert_equal(event_count, 8);
+  for (size_t i = 0; i < event_count; i += 2) {
+    zassert_equal(events[i].value, 1);
+    zassert_equal(events[i + 1].value, 2);
+  }
+}
+
+#ifdef CONFIG_PAW3222_ACCEL
+ZTEST(paw3222, test_accel_lut_curves) {
+  static uint16_t lut[PAW32XX_ACCEL_LUT_LEN];
+  struct paw32xx_accel_curve curve = {
+      .gain_max = 300,
+      .speed_min = 4,
+      .speed_max = 40,
+      .exponent = 2,
+  };
+  static const struct {
+    enum paw32xx_accel_curve_type type;
+    uint16_t mid;
+  } cases[] = {
+      {PAW32XX_ACCEL_LINEAR, 512},
+      {PAW32XX_ACCEL_POWER, 384},
+      {PAW32XX_ACCEL_SIGMOID, 512},
+  };
+
+  curve.type = PAW32XX_ACCEL_NONE;
+  paw32xx_accel_build_lut(&curve, lut);
+  for (int i = 0; i < PAW32XX_ACCEL_LUT_LEN; i++) {
+    zassert_equal(lut[i], PAW32XX_ACCEL_GAIN_ONE);
+  }
+
+  for (size_t c = 0; c < ARRAY_SIZE(cases); c++) {
+    curve.type = cases[c].type;
+    paw32xx_accel_build_lut(&curve, lut);
+
+    zassert_equal(lut[curve.speed_min], PAW32XX_ACCEL_GAIN_ONE, "curve %d", curve.type);
+    zassert_equal(lut[22], cases[c].mid, "curve %d", curve.type);
+    zassert_equal(lut[curve.speed_max], 3 * PAW32XX_ACCEL_GAIN_ONE, "curve %d", curve.type);
+    zassert_equal(lut[PAW32XX_ACCEL_LUT_LEN - 1], 3 * PAW32XX_ACCEL_GAIN_ONE);
+    for (int i = 1; i < PAW32XX_ACCEL_LUT_LEN; i++) {
+      zassert_true(lut[i] >= lut[i - 1], "curve %d not monotonic at %d", curve.type, i);
+    }
+  }
+}
+#endif
+
+#ifdef CONFIG_PAW3222_LATENCY_STATS
+ZTEST(paw3222, test_latency_histograms) {
+  struct paw32xx_latency_stats stats;
+  uint32_t total;
+
+  paw32xx_reset_latency_stats(dev);
+  for (int i = 0; i < 4; i++) {
+    zassert_ok(paw32xx_emul_push_motion(emul, 1, 2));
+  }
+  k_sleep(K_MSEC(200));
+
+  zassert_ok(paw32xx_get_latency_stats(dev, &stats));
+  for (int stage = 0; stage < PAW32XX_LATENCY_STAGES; stage++) {
+    const struct paw32xx_latency_hist *hist = &stats.stage[stage];
+
+    zassert_equal(hist->count, 4, "stage %d", stage);
+    total = 0;
+    for (int i = 0; i < PAW32XX_LATENCY_BUCKETS; i++) {
+      total += hist->buckets[i];
+    }
+    zassert_equal(total, hist->count, "stage %d", stage);
+  }
+
+  paw32xx_reset_latency_stats(dev);
+  zassert_ok(paw32xx_get_latency_stats(dev, &stats));
+  zassert_equal(stats.stage[PAW32XX_LATENCY_TOTAL].count, 0);
+}
+
+ZTEST(paw3222, test_latency_counts_sent_reports) {
+  struct paw32xx_data *data = dev->data;
+  struct paw32xx_latency_stats stats;
+
+  /* The first sample is sent at once, the rest wait for the window */
+  data->params.coalesce_us = 100000;
+  paw32xx_reset_latency_stats(dev);
+  for (int i = 0; i < 4; i++) {
+    zassert_ok(paw32xx_emul_push_motion(emul, 1, 2));
+  }
+  k_sleep(K_MSEC(50));
+
+  zassert_ok(paw32xx_get_latency_stats(dev, &stats));
+  zassert_equal(stats.stage[PAW32XX_LATENCY_TOTAL].count, 1);
+
+  /* The deferred report is timed once it is sent, including the wait */
+  k_sleep(K_MSEC(100));
+  zassert_ok(paw32xx_get_latency_stats(dev, &stats));
+  zassert_equal(stats.stage[PAW32XX_LATENCY_TOTAL].count, 2);
+  zassert_true(stats.stage[PAW32XX_LATENCY_REPORT].max_us >= 50000);
+
+  data->params.coalesce_us = 0;
+}
+#endif
+
+#ifdef CONFIG_PAW3222_QUEUE_WAIT_STATS
+ZTEST(paw3222, test_queue_wait_stats) {
+  struct paw32xx_queue_wait_stats stats;
+
+  paw32xx_reset_queue_wait_stats(dev);
+  for (int i = 0; i < 4; i++) {
+    zassert_ok(paw32xx_emul_push_motion(emul, 1, 2));
+  }
+  k_sleep(K_MSEC(200));
+
+  /* Every handler run started by the ISR or poll timer is measured once */
+  zassert_ok(paw32xx_get_queue_wait_stats(dev, &stats));
+  zassert_true(stats.count > 0);
+  zassert_true(stats.max_us >= stats.last_us);
+  zassert_true(stats.total_us >= stats.max_us);
+
+  paw32xx_reset_queue_wait_stats(dev);
+  zassert_ok(paw32xx_get_queue_wait_stats(dev, &stats));
+  zassert_equal(stats.count, 0);
+  zassert_equal(stats.max_us, 0);
+}
+#endif
+
+#ifdef CONFIG_PAW3222_MOTION_WORKQUEUE
+ZTEST(paw3222, test_motion_runs_on_dedicated_workqueue) {
+  zassert_ok(paw32xx_emul_push_motion(emul, 1, 2));
+  k_sleep(K_MSEC(50));
+
+  zassert_equal(event_count, 2);
+  zassert_not_equal(event_thread, k_current_get());
+  zassert_not_equal(event_thread, &k_sys_work_q.thread);
+}
+#endif
+
+#if defined(CONFIG_PM_DEVICE) && !defined(CONFIG_PAW3222_PM_AUTOSUSPEND)
+ZTEST(paw3222, test_power_gating_restores_configuration) {
+  const struct paw32xx_config *cfg = dev->config;
+  const struct gpio_dt_spec *power = &cfg->power_gpio;
+
+  zassert_not_null(power->port);
+  set_layer(LAYER_SNIPE);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), cfg->snipe_cpi / RES_STEP);
+
+  zassert_ok(paw32xx_pm_action(dev, PM_DEVICE_ACTION_SUSPEND));
+  zassert_equal(gpio_emul_output_get(power->port, power->pin), 0);
+
+  /* The sensor loses its registers while unpowered */
+  paw32xx_emul_set_reg(emul, PAW32XX_CPI_X, 1000 / RES_STEP);
+  paw32xx_emul_set_reg(emul, PAW32XX_CPI_Y, 1000 / RES_STEP);
+
+  zassert_ok(paw32xx_pm_action(dev, PM_DEVICE_ACTION_RESUME));
+  zassert_equal(gpio_emul_output_get(power->port, power->pin), 1);
+  k_msleep(1);
+
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), cfg->snipe_cpi / RES_STEP);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_Y), cfg->snipe_cpi / RES_STEP);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK,
+                cfg->force_awake ? 0 : OPERATION_MODE_SLP_MASK);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_WRITE_PROTECT), WRITE_PROTECT_ENABLE);
+}
+
+ZTEST(paw3222, test_power_gated_sensor_is_left_alone) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  struct paw32xx_emul_stats stats;
+
+  zassert_ok(paw32xx_pm_action(dev, PM_DEVICE_ACTION_SUSPEND));
+  zassert_false(paw32xx_is_powered(dev));
+  paw32xx_emul_reset_stats(emul);
+
+  /* Work submitted after the supply is cut does not touch the bus */
+  raise_layer(LAYER_SNIPE);
+  zassert_equal(k_work_submit(&data->motion_work), 1);
+  k_msleep(5);
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 0);
+  zassert_equal(data->current_cpi, cfg->res_cpi);
+  zassert_equal(event_count, 0);
+
+  /* Resume applies the mode change that was held back */
+  zassert_ok(paw32xx_pm_action(dev, PM_DEVICE_ACTION_RESUME));
+  zassert_true(paw32xx_is_powered(dev));
+  k_msleep(1);
+  zassert_equal(data->current_cpi, cfg->snipe_cpi);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), cfg->snipe_cpi / RES_STEP);
+}
+#endif
+
+#ifdef CONFIG_PAW3222_PM_AUTOSUSPEND
+ZTEST(paw3222, test_autosuspend_follows_motion) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+  /* Idle poll, auto-suspend delay and some slack */
+  k_timeout_t idle = K_MSEC(cfg->poll_max_us / USEC_PER_MSEC + cfg->autosuspend_ms + 10);
+  struct paw32xx_pm_stats stats;
+  enum pm_device_state state;
+
+  /* Samples driven directly by other tests may still hold a reference */
+  k_work_cancel_delayable(&data->pm_suspend_work);
+  paw32xx_pm_suspend_work_handler(&data->pm_suspend_work.work);
+  paw32xx_reset_pm_stats(dev);
+  zassert_ok(pm_device_state_get(dev, &state));
+  zassert_equal(state, PM_DEVICE_STATE_SUSPENDED);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK,
+                OPERATION_MODE_SLP_MASK);
+
+  /* The motion interrupt stays armed and resumes the sensor */
+  zassert_ok(paw32xx_emul_push_motion(emul, 3, 4));
+  k_msleep(1);
+  zassert_ok(pm_device_state_get(dev, &state));
+  zassert_equal(state, PM_DEVICE_STATE_ACTIVE);
+  zassert_equal(event_count, 2);
+
+  paw32xx_get_pm_stats(dev, &stats);
+  zassert_equal(stats.resumes, 1);
+  zassert_equal(stats.wake_count, 1);
+  zassert_equal(stats.wake_max_us, stats.wake_last_us);
+
+  k_sleep(idle);
+  zassert_ok(pm_device_state_get(dev, &state));
+  zassert_equal(state, PM_DEVICE_STATE_SUSPENDED);
+  paw32xx_get_pm_stats(dev, &stats);
+  zassert_equal(stats.suspends, 1);
+  zassert_equal(stats.wake_count, 1);
+}
+#endif
+
+#ifdef CONFIG_PAW3222_DYNAMIC_AWAKE
+ZTEST(paw3222, test_dynamic_awake_follows_activity) {
+  const struct paw32xx_config *cfg = dev->config;
+  const struct paw32xx_data *data = dev->data;
+  /* Idle poll, awake idle time and some slack */
+  k_timeout_t idle = K_MSEC(cfg->poll_max_us / USEC_PER_MSEC + cfg->awake_idle_ms + 10);
+  struct paw32xx_emul_stats emul_stats;
+  struct paw32xx_stats stats;
+
+  zassert_false(data->force_awake_active);
+
+  /* Motion disables the sleep modes with a single OPERATION_MODE write */
+  zassert_ok(paw32xx_emul_push_motion(emul, 2, 1));
+  k_msleep(1);
+  zassert_true(data->force_awake_active);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK, 0);
+  paw32xx_emul_get_stats(emul, &emul_stats);
+  zassert_equal(emul_stats.reg_writes, 3);
+
+  k_sleep(idle);
+  zassert_false(data->force_awake_active);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK,
+                OPERATION_MODE_SLP_MASK);
+
+  /* A scroll layer holds the sensor awake without motion */
+  set_layer(LAYER_SCROLL);
+  zassert_true(data->force_awake_active);
+  k_sleep(idle);
+  zassert_true(data->force_awake_active);
+
+  set_layer(LAYER_MOVE);
+  k_sleep(K_MSEC(cfg->awake_idle_ms + 10));
+  zassert_false(data->force_awake_active);
+
+  paw32xx_get_stats(dev, &stats);
+  zassert_equal(stats.awake_toggles, 4);
+}
+#endif
+
+#if defined(CONFIG_PAW3222_PM_AUTOSUSPEND) && defined(CONFIG_PAW3222_DYNAMIC_AWAKE)
+ZTEST(paw3222, test_resume_restores_dynamic_awake) {
+  const struct paw32xx_data *data = dev->data;
+  struct paw32xx_emul_stats stats;
+
+  /* A scroll layer keeps holding the sensor awake after a resume */
+  set_layer(LAYER_SCROLL);
+  zassert_true(data->force_awake_active);
+  zassert_ok(paw32xx_pm_action(dev, PM_DEVICE_ACTION_SUSPEND));
+  zassert_false(data->force_awake_active);
+  zassert_ok(paw32xx_pm_action(dev, PM_DEVICE_ACTION_RESUME));
+  k_msleep(1);
+  zassert_true(data->force_awake_active);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_OPERATION_MODE) & OPERATION_MODE_SLP_MASK, 0);
+
+  /* Without anything holding it awake, resume leaves the bus alone */
+  set_layer(LAYER_MOVE);
+  zassert_ok(paw32xx_pm_action(dev, PM_DEVICE_ACTION_SUSPEND));
+  paw32xx_emul_reset_stats(emul);
+  zassert_ok(paw32xx_pm_action(dev, PM_DEVICE_ACTION_RESUME));
+  k_msleep(1);
+  zassert_false(data->force_awake_active);
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 0);
+}
+#endif
+
+#ifdef CONFIG_PAW3222_TRACE
+ZTEST(paw3222, test_trace_records_samples) {
+  struct paw32xx_trace_entry entry;
+
+  paw32xx_trace_clear(dev);
+  paw32xx_trace_enable(dev, true);
+
+  run_motion_sample(5, -3);
+  zassert_equal(paw32xx_trace_len(dev), 1);
+  zassert_ok(paw32xx_trace_get(dev, 0, &entry));
+  zassert_equal(entry.x, 5);
+  zassert_equal(entry.y, -3);
+  zassert_true(entry.status & MOTION_STATUS_MOTION);
+  zassert_equal(entry.mode, PAW32XX_MOVE);
+  zassert_equal(paw32xx_trace_get(dev, 1, &entry), -ENOENT);
+
+  /* A full ring keeps the newest samples, oldest first */
+  for (int i = 0; i < CONFIG_PAW3222_TRACE_ENTRIES + 2; i++) {
+    run_motion_sample(i, 1);
+  }
+  zassert_equal(paw32xx_trace_len(dev), CONFIG_PAW3222_TRACE_ENTRIES);
+  zassert_ok(paw32xx_trace_get(dev, 0, &entry));
+  zassert_equal(entry.x, 2);
+
+  /* Stopping keeps the trace as it is */
+  paw32xx_trace_enable(dev, false);
+  run_motion_sample(9, 9);
+  zassert_ok(paw32xx_trace_get(dev, CONFIG_PAW3222_TRACE_ENTRIES - 1, &entry));
+  zassert_equal(entry.x, CONFIG_PAW3222_TRACE_ENTRIES + 1);
+  paw32xx_trace_enable(dev, true);
+}
+#endif
+
+#ifdef CONFIG_PAW3222_BEHAVIOR
+static int press_paw_mode(const struct device *behavior, uint32_t param) {
+  const struct behavior_driver_api *api = behavior->api;
+  struct zmk_behavior_binding binding = {
+      .behavior_dev = behavior->name,
+      .param1 = param,
+  };
+  struct zmk_behavior_binding_event event = {0};
+
+  return api->binding_pressed(&binding, event);
+}
+
+ZTEST(paw3222, test_behavior_routes_to_its_sensor) {
+  const struct device *thumb = DEVICE_DT_GET(DT_NODELABEL(thumbball));
+  const struct device *first = DEVICE_DT_GET_ANY(pixart_paw3222);
+  const struct device *other = (first == dev) ? thumb : dev;
+  struct paw32xx_data *thumb_data = thumb->data;
+  struct paw32xx_data *first_data = first->data;
+  struct paw32xx_data *other_data = other->data;
+  struct paw32xx_data *data = dev->data;
+
+  zassert_true(device_is_ready(thumb));
+  thumb_data->current_mode = PAW32XX_MODE_MOVE;
+
+  /* A sensor phandle routes the behavior to that instance only */
+  zassert_ok(press_paw_mode(DEVICE_DT_GET(DT_NODELABEL(paw_mode_thumb)), 0));
+  zassert_equal(thumb_data->current_mode, PAW32XX_MODE_SCROLL);
+  zassert_equal(data->current_mode, PAW32XX_MODE_MOVE);
+
+  /* Without one, the first PAW3222 instance is controlled */
+  thumb_data->current_mode = PAW32XX_MODE_MOVE;
+  zassert_ok(press_paw_mode(DEVICE_DT_GET(DT_NODELABEL(paw_mode_default)), 1));
+  zassert_equal(first_data->current_mode, PAW32XX_MODE_SNIPE);
+  zassert_equal(other_data->current_mode, PAW32XX_MODE_MOVE);
+
+  first_data->current_mode = PAW32XX_MODE_MOVE;
+  paw32xx_update_input_mode(first);
+  paw32xx_update_input_mode(other);
+  k_msleep(1);
+}
+
+ZTEST(paw3222, test_behavior_rejects_unready_sensor) {
+  const struct device *thumb = DEVICE_DT_GET(DT_NODELABEL(thumbball));
+  struct paw32xx_data *thumb_data = thumb->data;
+
+  thumb_data->current_mode = PAW32XX_MODE_MOVE;
+
+  /* Pretend init failed: the work items of such a device are unusable */
+  thumb->state->init_res = ENODEV;
+  zassert_false(device_is_ready(thumb));
+  zassert_equal(press_paw_mode(DEVICE_DT_GET(DT_NODELABEL(paw_mode_thumb)), 1), -ENODEV);
+  zassert_equal(thumb_data->current_mode, PAW32XX_MODE_MOVE);
+  thumb->state->init_res = 0;
+}
+#endif
+
+/* The suite checks events right after each sample, which needs synchronous input */
+static bool paw3222_sync_input(const void *global_state) {
+  ARG_UNUSED(global_state);
+
+  return !IS_ENABLED(CONFIG_INPUT_MODE_THREAD);
+}
+
+#ifdef CONFIG_PAW3222_SHELL
+/* Run a shell command on the dummy backend and return its output */
+static const char *run_shell(int expected, const char *fmt, ...) {
+  const struct shell *sh = shell_backend_dummy_get_ptr();
+  char cmd[64];
+  size_t size;
+  va_list args;
+
+  va_start(args, fmt);
+  vsnprintk(cmd, sizeof(cmd), fmt, args);
+  va_end(args);
+
+  shell_backend_dummy_clear_output(sh);
+  zassert_equal(shell_execute_cmd(sh, cmd), expected, "%s", cmd);
+  return shell_backend_dummy_get_output(sh, &size);
+}
+
+ZTEST(paw3222, test_shell_reg_read) {
+  char expected[16];
+
+  snprintk(expected, sizeof(expected), "0x00: 0x%02x", PRODUCT_ID_PAW32XX);
+  zassert_not_null(strstr(run_shell(0, "paw3222 reg read %s 0", dev->name), expected));
+  zassert_not_null(strstr(run_shell(0, "paw3222 list"), dev->name));
+}
+
+ZTEST(paw3222, test_shell_refuses_driver_owned_registers) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_emul_stats stats;
+  static const uint8_t owned[] = {
+      PAW32XX_WRITE_PROTECT,
+      PAW32XX_CONFIGURATION,
+      PAW32XX_CPI_X,
+      PAW32XX_CPI_Y,
+  };
+
+  /* The driver's CPI and reset state must not change behind its back */
+  for (size_t i = 0; i < ARRAY_SIZE(owned); i++) {
+    run_shell(-EINVAL, "paw3222 reg write %s 0x%02x 0x10", dev->name, owned[i]);
+  }
+  paw32xx_emul_get_stats(emul, &stats);
+  zassert_equal(stats.transfers, 0);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), cfg->res_cpi / RES_STEP);
+
+  /* Resolution changes go through the driver instead */
+  run_shell(0, "paw3222 param %s cpi %d", dev->name, cfg->snipe_cpi);
+  k_msleep(1);
+  zassert_equal(paw32xx_emul_get_reg(emul, PAW32XX_CPI_X), cfg->snipe_cpi / RES_STEP);
+  run_shell(0, "paw3222 param %s cpi %d", dev->name, cfg->res_cpi);
+  k_msleep(1);
+}
+
+ZTEST(paw3222, test_shell_params_apply_on_motion_queue) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+
+  /* Motion work must not see the parameters change mid-sample */
+  k_sched_lock();
+  run_shell(0, "paw3222 param %s scroll-tick %d", dev->name, cfg->scroll_tick + 1);
+  zassert_equal(data->params.scroll_tick, cfg->scroll_tick);
+  k_sched_unlock();
+
+  k_msleep(1);
+  zassert_equal(data->params.scroll_tick, cfg->scroll_tick + 1);
+  run_shell(0, "paw3222 param %s scroll-tick %d", dev->name, cfg->scroll_tick);
+  k_msleep(1);
+  zassert_equal(data->params.scroll_tick, cfg->scroll_tick);
+}
+#endif
+
+ZTEST_SUITE(paw3222, paw3222_sync_input, paw3222_setup, paw3222_before, paw3222_after, NULL);
+
+#if defined(CONFIG_INPUT_MODE_THREAD) && defined(CONFIG_PAW3222_REPORT_NONBLOCKING)
+/*
+ * With the input thread at the lowest priority, events stay in the input
+ * queue (CONFIG_INPUT_QUEUE_MAX_MSGS deep) until the test thread sleeps.
+ */
+#define INPUT_QUEUE_DEPTH CONFIG_INPUT_QUEUE_MAX_MSGS
+
+static void drain_input(void) {
+  k_msleep(10);
+}
+
+/* Take a queue slot with an event the test callback does not record */
+static void occupy_input_queue(int slots) {
+  for (int i = 0; i < slots; i++) {
+    zassert_ok(input_report_key(NULL, INPUT_KEY_A, 1, true, K_NO_WAIT));
+  }
+}
+
+static void report_queue_before(void *fixture) {
+  paw3222_before(fixture);
+  drain_input();
+  event_count = 0;
+}
+
+ZTEST(paw3222_report_queue, test_full_queue_merges_deltas) {
+  struct paw32xx_stats stats;
+
+  /* Room for X only: Y stays pending and X goes out without sync */
+  occupy_input_queue(INPUT_QUEUE_DEPTH - 1);
+  run_motion_sample(5, 6);
+
+  /* No room at all: both axes are merged into the pending deltas */
+  run_motion_sample(1, 2);
+
+  drain_input();
+  zassert_equal(event_count, 1);
+  zassert_equal(events[0].code, INPUT_REL_X);
+  zassert_equal(events[0].value, 5);
+  zassert_false(events[0].sync, "X must not sync while Y is pending");
+
+  /* The next report carries the merged totals */
+  run_motion_sample(0, 0);
+  drain_input();
+  zassert_equal(event_count, 3);
+  zassert_equal(events[1].code, INPUT_REL_X);
+  zassert_equal(events[1].value, 1);
+  zassert_false(events[1].sync);
+  zassert_equal(events[2].code, INPUT_REL_Y);
+  zassert_equal(events[2].value, 6 + 2);
+  zassert_true(events[2].sync);
+
+  zassert_ok(paw32xx_get_stats(dev, &stats));
+  zassert_equal(stats.report_merges, 2);
+  zassert_equal(stats.reports, 1);
+}
+
+ZTEST_SUITE(paw3222_report_queue, NULL, NULL, report_queue_before, paw3222_after, NULL);
+#endif
@@ -0,0 +1,14 @@
+/*
+ * Copyright 2025 nuovotaka
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdint.h>
+
+#include <zmk/keymap.h>
+
+#include "zmk_stubs.h"
+
+uint8_t paw32xx_test_layer;
+
+uint8_t zmk_keymap_highest_layer_active(void) { return paw32xx_test_layer; }
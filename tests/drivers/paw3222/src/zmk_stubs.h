@@ -0,0 +1,11 @@
+/*
+ * Copyright 2025 nuovotaka
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/** Layer reported by the zmk_keymap_highest_layer_active() stub */
+extern uint8_t paw32xx_test_layer;
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2025 nuovotaka
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Replays a motion trace recorded with CONFIG_PAW3222_TRACE through
+ * paw32xx_process_sample(), the same code the motion work handler runs,
+ * and prints every emitted input event. Coalescing is disabled and the
+ * sample timestamps come from the trace, so the output only depends on the
+ * trace, the devicetree configuration and the driver code: diff it to
+ * compare tunings or driver versions.
+ */
+
+#include <string.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/input/input.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/ztest.h>
+
+#include "paw3222.h"
+#include "paw3222_input.h"
+#include "paw3222_regs.h"
+
+#define PAW_NODE DT_NODELABEL(trackball)
+
+/* 32-bit FNV-1a */
+#define FNV_OFFSET 0x811c9dc5U
+#define FNV_PRIME 0x01000193U
+
+static const struct device *const dev = DEVICE_DT_GET(PAW_NODE);
+
+static const struct paw32xx_trace_entry trace[] = {
+#include "trace.inc"
+};
+
+static bool print_events;
+static size_t event_count;
+static uint32_t event_hash;
+
+static void hash_add(const void *buf, size_t len) {
+  const uint8_t *bytes = buf;
+
+  for (size_t i = 0; i < len; i++) {
+    event_hash = (event_hash ^ bytes[i]) * FNV_PRIME;
+  }
+}
+
+static void replay_input_cb(struct input_event *evt) {
+  uint8_t sync = evt->sync;
+
+  if (evt->type != INPUT_EV_REL) {
+    return;
+  }
+
+  hash_add(&evt->code, sizeof(evt->code));
+  hash_add(&evt->value, sizeof(evt->value));
+  hash_add(&sync, sizeof(sync));
+  event_count++;
+
+  if (print_events) {
+    printk("event %u %d %u\n", evt->code, evt->value, sync);
+  }
+}
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(PAW_NODE), replay_input_cb);
+
+/* Start from the state the driver has right after boot */
+static void replay_reset(void) {
+  const struct paw32xx_config *cfg = dev->config;
+  struct paw32xx_data *data = dev->data;
+
+  gpio_pin_interrupt_configure_dt(&cfg->irq_gpio, GPIO_INT_DISABLE);
+  k_timer_stop(&data->motion_timer);
+  k_work_cancel_delayable(&data->report_work);
+
+  data->params.coalesce_us = 0;
+  data->report_window_open = false;
+  memset(data->report_pending, 0, sizeof(data->report_pending));
+  data->scroll_accumulator = 0;
+  data->snipe_remainder_x = 0;
+  data->snipe_remainder_y = 0;
+  data->scroll_snipe_remainder = 0;
+  data->cpi_remainder_x = 0;
+  data->cpi_remainder_y = 0;
+#ifdef CONFIG_PAW3222_ACCEL
+  data->accel_remainder_x = 0;
+  data->accel_remainder_y = 0;
+  data->accel_last_us = trace[0].time_us;
+#endif
+
+  event_count = 0;
+  event_hash = FNV_OFFSET;
+}
+
+/* Feed every motion sample of the trace through the driver */
+static size_t replay(void) {
+  size_t samples = 0;
+
+  replay_reset();
+
+  for (size_t i = 0; i < ARRAY_SIZE(trace); i++) {
+    /* Samples without motion only mark the end of a stroke */
+    if ((trace[i].status & MOTION_STATUS_MOTION) == 0) {
+      continue;
+    }
+
+    paw32xx_process_sample(dev, trace[i].mode, trace[i].x, trace[i].y, trace[i].time_us);
+    samples++;
+  }
+
+  return samples;
+}
+
+ZTEST(paw3222_replay, test_replay_prints_events) {
+  size_t samples;
+
+  print_events = true;
+  samples = replay();
+  print_events = false;
+
+  printk("replayed %zu samples: %zu events, hash 0x%08x\n", samples, event_count, event_hash);
+  zassert_true(samples > 0, "trace has no motion samples");
+  zassert_true(event_count > 0, "trace produced no input events");
+}
+
+ZTEST(paw3222_replay, test_replay_is_deterministic) {
+  size_t first_count;
+  uint32_t first_hash;
+
+  replay();
+  first_count = event_count;
+  first_hash = event_hash;
+
+  replay();
+  zassert_equal(event_count, first_count);
+  zassert_equal(event_hash, first_hash);
+}
+
+ZTEST_SUITE(paw3222_replay, NULL, NULL, NULL, NULL, NULL);